@@ -0,0 +1,246 @@
+#include "alloc_tracker.h"
+
+#ifdef PIPELINE_ALLOC_TRACKING
+
+#include <stdlib.h>
+#ifdef ARDUINO
+#include "diagnostics.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <stdio.h>
+#endif
+
+// Обертки, подставляемые линковщиком вместо malloc/free (--wrap)
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+}
+
+static volatile uint32_t s_total_allocs = 0;
+static volatile uint32_t s_total_frees = 0;
+static volatile bool s_window_active = false;
+static volatile uint32_t s_window_events = 0;
+static volatile size_t s_window_last_size = 0;
+static volatile uint32_t s_violations = 0;
+static int s_windows_seen = 0;
+
+// Бюджет стека по задачам. Записи добавляет создатель задач до начала их
+// работы; max_used и paint_end меняет только сама задача
+struct TaskStackRecord {
+    const char* name;
+    uint32_t* bottom;               // выровнено на слово вверх
+    uint8_t* top;
+    uint32_t stack_size;
+    uint32_t budget;
+    uint32_t max_used;              // наибольшая глубина за единицу работы
+    uint32_t* paint_end;            // граница окраски текущей единицы работы
+};
+
+static TaskStackRecord s_tasks[ALLOC_TRACKER_MAX_TASKS];
+static volatile int s_task_count = 0;
+
+static inline void countEvent(volatile uint32_t* counter, size_t size) {
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+    if (s_window_active) {
+        __atomic_fetch_add(&s_window_events, 1, __ATOMIC_RELAXED);
+        s_window_last_size = size;
+    }
+}
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+    countEvent(&s_total_allocs, size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    countEvent(&s_total_allocs, count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    countEvent(&s_total_allocs, size);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr != nullptr) {
+        countEvent(&s_total_frees, 0);
+    }
+    __real_free(ptr);
+}
+
+} // extern "C"
+
+static void trackerFail(const char* task, const char* reason, uint32_t value) {
+#ifdef ARDUINO
+    DIAG_ERROR("❌ НАРУШЕНИЕ БЮДЖЕТА КОНВЕЙЕРА: ");
+    DIAG_ERROR(task);
+    DIAG_ERROR(": ");
+    DIAG_ERROR(reason);
+    DIAG_ERROR(" ");
+    DIAG_ERRORLN(value);
+#if DIAG_ENABLED(DIAG_LEVEL_ERROR)
+    Serial.flush();
+#endif
+    abort();
+#else
+    fprintf(stderr, "НАРУШЕНИЕ БЮДЖЕТА КОНВЕЙЕРА: %s: %s %u\n", task, reason, (unsigned)value);
+    __atomic_fetch_add(&s_violations, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// Запись задачи, в чей стек попадает текущая вершина
+static TaskStackRecord* currentTask() {
+    uint8_t* sp = (uint8_t*)__builtin_frame_address(0);
+    for (int i = 0; i < s_task_count; i++) {
+        if (sp >= (uint8_t*)s_tasks[i].bottom && sp < s_tasks[i].top) {
+            return &s_tasks[i];
+        }
+    }
+    return nullptr;
+}
+
+void stackBudgetRegister(const char* name, void* stack_bottom, uint32_t stack_size, uint32_t budget) {
+    // Та же вершина - повторная регистрация; иначе свободная запись
+    uint8_t* top = (uint8_t*)stack_bottom + stack_size;
+    int index = 0;
+    while (index < s_task_count && s_tasks[index].top != top) {
+        index++;
+    }
+    if (index == s_task_count) {
+        index = 0;
+        while (index < s_task_count && s_tasks[index].top != nullptr) {
+            index++;
+        }
+    }
+    if (index == ALLOC_TRACKER_MAX_TASKS) {
+        return;
+    }
+    TaskStackRecord& record = s_tasks[index];
+    record.name = name;
+    record.bottom = (uint32_t*)(((uintptr_t)stack_bottom + 3) & ~(uintptr_t)3);
+    record.top = top;
+    record.stack_size = stack_size;
+    record.budget = budget;
+    record.max_used = 0;
+    record.paint_end = nullptr;
+    if (index == s_task_count) {
+        __atomic_store_n(&s_task_count, index + 1, __ATOMIC_RELEASE);
+    }
+}
+
+#ifdef ARDUINO
+void stackBudgetRegisterTask(TaskHandle_t task, uint32_t stack_size, uint32_t budget) {
+    // На ESP-IDF размер стека задается в байтах, стек растет вниз от
+    // pxTaskGetStackStart() + stack_size
+    stackBudgetRegister(pcTaskGetName(task), pxTaskGetStackStart(task), stack_size, budget);
+}
+#endif
+
+void stackBudgetUnregisterCurrentTask() {
+    TaskStackRecord* record = currentTask();
+    if (record != nullptr) {
+        record->bottom = nullptr;
+        record->top = nullptr;
+    }
+}
+
+void stackBudgetBegin() {
+    TaskStackRecord* record = currentTask();
+    if (record == nullptr) {
+        return;
+    }
+    uint8_t* limit = (uint8_t*)__builtin_frame_address(0) - STACK_PAINT_GUARD;
+    uint32_t* end = (uint32_t*)((uintptr_t)limit & ~(uintptr_t)3);
+    for (volatile uint32_t* word = record->bottom; word < end; word++) {
+        *word = STACK_PAINT_PATTERN;
+    }
+    record->paint_end = end;
+}
+
+void stackBudgetEnd() {
+    TaskStackRecord* record = currentTask();
+    if (record == nullptr || record->paint_end == nullptr) {
+        return;
+    }
+    // Окраска стирается снизу вверх не обязательно подряд: глубина -
+    // по самому нижнему затертому слову
+    const volatile uint32_t* word = record->bottom;
+    while (word < record->paint_end && *word == STACK_PAINT_PATTERN) {
+        word++;
+    }
+    uint32_t used = (uint32_t)(record->top - (const uint8_t*)word);
+    record->paint_end = nullptr;
+    if (used > record->max_used) {
+        record->max_used = used;
+    }
+    if (used > record->budget) {
+        trackerFail(record->name, "стек превысил бюджет, байт:", used);
+    }
+}
+
+void allocTrackerWindowBegin() {
+    s_window_events = 0;
+    s_window_active = true;
+    stackBudgetBegin();
+}
+
+void allocTrackerWindowEnd() {
+    s_window_active = false;
+    stackBudgetEnd();
+
+    if (++s_windows_seen <= PIPELINE_WARMUP_WINDOWS) {
+        return;
+    }
+    if (s_window_events != 0) {
+#ifdef ARDUINO
+        DIAG_ERROR("Последний запрошенный размер: ");
+        DIAG_ERRORLN((uint32_t)s_window_last_size);
+#endif
+        trackerFail("окно", "обращений к куче за окно:", s_window_events);
+    }
+}
+
+uint32_t allocTrackerTotalAllocs() {
+    return s_total_allocs;
+}
+
+uint32_t allocTrackerTotalFrees() {
+    return s_total_frees;
+}
+
+uint32_t allocTrackerViolations() {
+    return s_violations;
+}
+
+uint32_t stackBudgetMaxUsed() {
+    TaskStackRecord* record = currentTask();
+    return record != nullptr ? record->max_used : 0;
+}
+
+void allocTrackerReport() {
+#ifdef ARDUINO
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== УЧЕТ ПАМЯТИ ===");
+    Serial.print("Выделений/освобождений с запуска: ");
+    Serial.print(s_total_allocs); Serial.print(" / "); Serial.println(s_total_frees);
+    for (int i = 0; i < s_task_count; i++) {
+        const TaskStackRecord& r = s_tasks[i];
+        if (r.top == nullptr) {
+            continue;
+        }
+        Serial.print("Задача "); Serial.print(r.name);
+        Serial.print(": стек за единицу работы до "); Serial.print(r.max_used);
+        Serial.print(" из "); Serial.print(r.stack_size);
+        Serial.print(" (бюджет "); Serial.print(r.budget); Serial.println(")");
+    }
+#endif
+#endif
+}
+
+#endif // PIPELINE_ALLOC_TRACKING
@@ -0,0 +1,90 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+// Инструментирование установившегося режима конвейера (захват -> признаки ->
+// инференс). Включается флагом -DPIPELINE_ALLOC_TRACKING вместе с
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+// (см. env:seeed_xiao_esp32s3_alloc_check и env:native в platformio.ini).
+// Без флага все функции пустые и исчезают при компиляции.
+//
+// Стек меряется окраской, а не всевременным минимумом запаса FreeRTOS
+// (тот включает setup(), AllocateTensors() и отчеты загрузки): в начале
+// единицы работы задачи (окно loop(), задание рабочей задачи) свободная часть
+// ее стека ниже текущей вершины заполняется STACK_PAINT_PATTERN, в конце
+// глубина - от вершины до первого затертого слова от дна. Стек и бюджет
+// каждой задачи конвейера регистрирует ее создатель (до начала работы);
+// задача определяется по тому, в чей стек попадает текущая вершина.
+// Не зависит от FreeRTOS, кроме регистрации текущей задачи: нативные тесты
+// (test/test_pipeline_budget) гоняют те же проверки на хосте
+
+// Бюджет стека задачи loop() на одно окно, байт
+const uint32_t PIPELINE_STACK_BUDGET = 4096;
+
+// Первые окна могут выделять память лениво (буферы Serial, драйверы),
+// поэтому проверка кучи начинается после прогрева. Стек проверяется всегда
+const int PIPELINE_WARMUP_WINDOWS = 2;
+
+// Максимум задач, для которых хранится бюджет стека
+const int ALLOC_TRACKER_MAX_TASKS = 6;
+
+const uint32_t STACK_PAINT_PATTERN = 0xA5A5A5A5u;
+const uint32_t STACK_PAINT_GUARD = 256;  // байт под вершиной не красятся (кадр самой окраски)
+
+#ifdef PIPELINE_ALLOC_TRACKING
+
+// Регистрация стека [stack_bottom, stack_bottom + stack_size) с бюджетом
+// глубины на единицу работы
+void stackBudgetRegister(const char* name, void* stack_bottom, uint32_t stack_size, uint32_t budget);
+
+#ifdef ARDUINO
+// Регистрация задачи FreeRTOS (nullptr - текущая; границы стека - из TCB)
+void stackBudgetRegisterTask(TaskHandle_t task, uint32_t stack_size, uint32_t budget);
+#endif
+
+// Снятие регистрации текущей задачи перед ее удалением (стек освобождается)
+void stackBudgetUnregisterCurrentTask();
+
+// Единица работы текущей задачи: окраска свободного стека и проверка глубины.
+// Незарегистрированная задача пропускается
+void stackBudgetBegin();
+void stackBudgetEnd();
+
+// Границы одного окна конвейера в loop(). allocTrackerWindowEnd() проверяет,
+// что за окно не было ни одного обращения к куче (из любой задачи) и что
+// стек loop() не вышел за бюджет. На устройстве нарушение печатает причину
+// и останавливает прошивку, на хосте - считается (allocTrackerViolations)
+void allocTrackerWindowBegin();
+void allocTrackerWindowEnd();
+
+// Счетчики с момента старта (для отчета и тестов)
+uint32_t allocTrackerTotalAllocs();
+uint32_t allocTrackerTotalFrees();
+uint32_t allocTrackerViolations();
+
+// Наибольшая глубина стека текущей задачи за одну единицу работы, байт
+uint32_t stackBudgetMaxUsed();
+
+void allocTrackerReport();
+
+#else
+
+#ifdef ARDUINO
+inline void stackBudgetRegisterTask(TaskHandle_t, uint32_t, uint32_t) {}
+#endif
+inline void stackBudgetUnregisterCurrentTask() {}
+inline void stackBudgetBegin() {}
+inline void stackBudgetEnd() {}
+inline void allocTrackerWindowBegin() {}
+inline void allocTrackerWindowEnd() {}
+inline void allocTrackerReport() {}
+
+#endif // PIPELINE_ALLOC_TRACKING
+
+#endif // ALLOC_TRACKER_H
@@ -0,0 +1,166 @@
+#include "audio_capture.h"
+#include "memory_plan.h"
+#include <string.h>
+#ifdef ARDUINO
+#include "diagnostics.h"
+
+// Конфигурация I2S для PDM микрофона
+static const i2s_config_t i2s_config = {
+    .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM),
+    .sample_rate = CAPTURE_RATE,
+    .bits_per_sample = (i2s_bits_per_sample_t)SAMPLE_BITS,
+    .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
+    .communication_format = I2S_COMM_FORMAT_STAND_I2S,
+    .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+    .dma_buf_count = I2S_DMA_BUF_COUNT,
+    .dma_buf_len = I2S_DMA_BUF_LEN,
+    .use_apll = false,
+    .tx_desc_auto_clear = false,
+    .fixed_mclk = 0
+};
+
+// Конфигурация пинов I2S для XIAO ESP32S3
+static const i2s_pin_config_t pin_config = {
+    .mck_io_num = I2S_PIN_NO_CHANGE,
+    .bck_io_num = I2S_PIN_NO_CHANGE,  // PDM Clock - встроенный
+    .ws_io_num = I2S_PIN_NO_CHANGE,   // PDM Data - встроенный
+    .data_out_num = I2S_PIN_NO_CHANGE,
+    .data_in_num = I2S_PIN_NO_CHANGE  // Используем встроенный PDM микрофон
+};
+#endif
+
+static uint32_t s_hop_count = 0;
+static Int16Stats s_hop_stats[CAPTURE_RING_HOPS];  // статистика шага в слоте кольца
+static SignalConditioner s_conditioner;
+
+#ifdef CAPTURE_SAMPLE_RATE
+static Resampler s_resampler;
+// Таблица строится при запуске и только читается ресемплером: обычная
+// статическая память, не DMA-арена (при 44.1 кГц - около 30 КБ)
+static int16_t s_resampler_coeffs[CAPTURE_RESAMPLER_TABLE_SIZE];
+static int s_raw_count = 0;  // сырых отсчетов в capture_raw
+static int s_raw_pos = 0;    // из них уже поданных в ресемплер
+#endif
+
+// Кондиционирование записанного в кольцо шага и его статистика
+static void finishHop(int slot, int16_t* hop) {
+    resetStats(&s_hop_stats[slot]);
+    conditionSamplesWithStats(&s_conditioner, hop, HOP_LENGTH, 0, &s_hop_stats[slot]);
+    s_hop_count++;
+}
+
+#ifdef ARDUINO
+esp_err_t captureBegin() {
+    initConditioner(&s_conditioner, CAPTURE_DC_POLE, CAPTURE_PREEMPHASIS, CAPTURE_GAIN);
+#ifdef CAPTURE_SAMPLE_RATE
+    if (!resamplerInit(&s_resampler, CAPTURE_RATE, SAMPLE_RATE, s_resampler_coeffs,
+                       CAPTURE_RESAMPLER_TABLE_SIZE)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#endif
+    esp_err_t err = i2s_driver_install(CAPTURE_I2S_PORT, &i2s_config, 0, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return i2s_set_pin(CAPTURE_I2S_PORT, &pin_config);
+}
+
+esp_err_t captureReadHop(TickType_t timeout) {
+    int slot = s_hop_count % CAPTURE_RING_HOPS;
+    int16_t* hop = g_pipeline_arena.capture_ring + slot * HOP_LENGTH;
+    
+#ifdef CAPTURE_SAMPLE_RATE
+    // Шаг собирается из сырых отсчетов; остаток прочитанного переходит в
+    // следующий шаг. Как и при прямом чтении, неполный шаг при таймауте теряется
+    int produced = 0;
+    while (produced < HOP_LENGTH) {
+        if (s_raw_pos == s_raw_count) {
+            size_t bytes_read = 0;
+            esp_err_t err = i2s_read(CAPTURE_I2S_PORT, g_pipeline_arena.capture_raw,
+                                     CAPTURE_HOP_SAMPLES * sizeof(int16_t), &bytes_read, timeout);
+            s_raw_count = bytes_read / sizeof(int16_t);
+            s_raw_pos = 0;
+            if (err != ESP_OK || s_raw_count == 0) {
+                return err != ESP_OK ? err : ESP_ERR_TIMEOUT;
+            }
+        }
+        int consumed = 0;
+        produced += resamplerProcess(&s_resampler, g_pipeline_arena.capture_raw + s_raw_pos,
+                                     s_raw_count - s_raw_pos, &consumed, hop + produced, HOP_LENGTH - produced);
+        s_raw_pos += consumed;
+    }
+#else
+    size_t bytes_read = 0;
+    esp_err_t err = i2s_read(CAPTURE_I2S_PORT, hop, HOP_LENGTH * sizeof(int16_t), &bytes_read, timeout);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (bytes_read != HOP_LENGTH * sizeof(int16_t)) {
+        return ESP_ERR_TIMEOUT;
+    }
+#endif
+    
+    finishHop(slot, hop);
+    return ESP_OK;
+}
+#else
+void captureHostBegin() {
+    initConditioner(&s_conditioner, CAPTURE_DC_POLE, CAPTURE_PREEMPHASIS, CAPTURE_GAIN);
+    s_hop_count = 0;
+}
+
+void captureHostHop(const int16_t* samples) {
+    int slot = s_hop_count % CAPTURE_RING_HOPS;
+    int16_t* hop = g_pipeline_arena.capture_ring + slot * HOP_LENGTH;
+    memcpy(hop, samples, HOP_LENGTH * sizeof(int16_t));
+    finishHop(slot, hop);
+}
+#endif
+
+void captureResetStream() {
+    resetConditioner(&s_conditioner);
+#ifdef CAPTURE_SAMPLE_RATE
+    resamplerReset(&s_resampler);
+    s_raw_count = 0;
+    s_raw_pos = 0;
+#endif
+}
+
+const int16_t* captureRing() {
+    return g_pipeline_arena.capture_ring;
+}
+
+uint32_t captureHopCount() {
+    return s_hop_count;
+}
+
+int captureTailStart(int num_samples) {
+    int end = (s_hop_count % CAPTURE_RING_HOPS) * HOP_LENGTH;
+    int start = end - num_samples;
+    return start < 0 ? start + CAPTURE_RING_SIZE : start;
+}
+
+int captureWindowStart() {
+    return captureTailStart(WINDOW_SAMPLES);
+}
+
+void captureWindowStats(Int16Stats* stats) {
+    resetStats(stats);
+    int hops = s_hop_count < (uint32_t)CAPTURE_RING_HOPS ? (int)s_hop_count : CAPTURE_RING_HOPS;
+    for (int slot = 0; slot < hops; slot++) {
+        mergeStats(s_hop_stats[slot], stats);
+    }
+}
+
+#ifdef ARDUINO
+void reportCaptureResampler() {
+#if defined(CAPTURE_SAMPLE_RATE) && DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.print("Захват "); Serial.print(CAPTURE_RATE);
+    Serial.print(" Гц -> "); Serial.print(SAMPLE_RATE);
+    Serial.print(" Гц: "); Serial.print(s_resampler.up); Serial.print("/"); Serial.print(s_resampler.down);
+    Serial.print(", "); Serial.print(s_resampler.taps); Serial.print(" отводов на отсчет, ядро ");
+    Serial.print(s_resampler.kernel_name); Serial.print(", задержка ");
+    Serial.print(resamplerDelay(s_resampler) * 1000.0f / SAMPLE_RATE); Serial.println(" мс");
+#endif
+}
+#endif
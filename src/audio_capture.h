@@ -0,0 +1,119 @@
+#ifndef AUDIO_CAPTURE_H
+#define AUDIO_CAPTURE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "driver/i2s.h"
+#endif
+#include "audio_processing.h"
+#include "signal_stats.h"
+#include "resampler.h"
+
+// Захват звука со встроенного PDM микрофона шагами по HOP_LENGTH отсчетов
+// прямо в кольцо, из которого читает фронтенд (без промежуточных буферов).
+// На хосте I2S нет: шаги подает нативный тест (captureHostHop)
+#ifdef ARDUINO
+const i2s_port_t CAPTURE_I2S_PORT = I2S_NUM_0;
+#endif
+const int SAMPLE_BITS = 16;
+
+// Захват на другой частоте (сборка с -DCAPTURE_SAMPLE_RATE=48000 и т.п.):
+// I2S читает сырые отсчеты в буфер capture_raw, полифазный ресемплер
+// (resampler.h) пишет шаг частоты фронтенда в кольцо
+#ifdef CAPTURE_SAMPLE_RATE
+const int CAPTURE_RATE = CAPTURE_SAMPLE_RATE;
+static_assert(CAPTURE_RATE != SAMPLE_RATE, "CAPTURE_SAMPLE_RATE задается только для другой частоты");
+static_assert(resamplerTaps(CAPTURE_RATE, SAMPLE_RATE) <= RESAMPLER_MAX_TAPS,
+              "понижение частоты захвата больше допустимого для ресемплера");
+#else
+const int CAPTURE_RATE = SAMPLE_RATE;
+#endif
+
+// Сырых отсчетов на шаг фронтенда (с округлением вверх)
+const int CAPTURE_HOP_SAMPLES = (HOP_LENGTH * CAPTURE_RATE + SAMPLE_RATE - 1) / SAMPLE_RATE;
+const int CAPTURE_RESAMPLER_TABLE_SIZE = resamplerTableSize(CAPTURE_RATE, SAMPLE_RATE);
+
+// Кондиционирование шага сразу после чтения, в одном проходе со статистикой
+// (SignalConditioner, signal_stats.h): постоянная составляющая PDM микрофона
+// удаляется всегда. Предыскажение и усиление меняют признаки, на которых
+// обучена модель, поэтому включаются флагами сборки, например
+// -DCAPTURE_PREEMPHASIS=0.97f -DCAPTURE_GAIN=2.0f
+#ifndef CAPTURE_PREEMPHASIS
+#define CAPTURE_PREEMPHASIS 0.0f
+#endif
+#ifndef CAPTURE_GAIN
+#define CAPTURE_GAIN 1.0f
+#endif
+const float CAPTURE_DC_POLE = 0.995f;  // срез ~13 Гц при 16 кГц
+
+// Геометрия DMA выводится из шага кадра: один DMA-буфер = один шаг,
+// поэтому каждое пробуждение по i2s_read отдает ровно один шаг
+const int I2S_DMA_BUF_LEN = CAPTURE_HOP_SAMPLES;
+
+// Бюджет окна: пока loop() считает окно (пересчет спектрограммы, каскад
+// моделей, отчеты при DIAG_LEVEL >= INFO), I2S не читается и шаги копятся
+// в DMA-буферах. Буферов хватает на CAPTURE_WINDOW_BUDGET_MS плюс два шага
+// запаса; окно дольше запаса теряет шаги, и поток начинается заново.
+// Отчет окна (INFO) печатает измеренное время окна с отчетами и без них:
+// бюджет подбирается по нему флагом -DCAPTURE_WINDOW_BUDGET_MS=...
+// Цена - внутренняя DMA-память: I2S_DMA_BUF_COUNT * I2S_DMA_BUF_LEN * 2 байт
+// (16.6 КБ при 16 кГц, 50 КБ при захвате 48 кГц для бюджета 500 мс)
+#ifndef CAPTURE_WINDOW_BUDGET_MS
+#define CAPTURE_WINDOW_BUDGET_MS 500
+#endif
+const int I2S_DMA_MAX_BUF_COUNT = 128;  // предел драйвера I2S
+const int I2S_DMA_BUF_COUNT = (CAPTURE_WINDOW_BUDGET_MS * SAMPLE_RATE / 1000 + HOP_LENGTH - 1) / HOP_LENGTH + 2;
+static_assert(I2S_DMA_BUF_COUNT <= I2S_DMA_MAX_BUF_COUNT, "бюджет окна больше кольца DMA драйвера I2S");
+
+// Время, на которое можно не читать I2S без потери отсчетов, мс
+const int CAPTURE_SLACK_MS = I2S_DMA_BUF_COUNT * HOP_LENGTH * 1000 / SAMPLE_RATE;
+const size_t CAPTURE_DMA_BYTES = (size_t)I2S_DMA_BUF_COUNT * I2S_DMA_BUF_LEN * sizeof(int16_t);
+
+// Кольцо захвата: целое число шагов, вмещающее одно окно фронтенда
+const int CAPTURE_RING_HOPS = (WINDOW_SAMPLES + HOP_LENGTH - 1) / HOP_LENGTH;
+const int CAPTURE_RING_SIZE = CAPTURE_RING_HOPS * HOP_LENGTH;
+const int CAPTURE_BUFFER_ALIGN = 64;  // строка кэша ESP32-S3
+
+#ifdef ARDUINO
+esp_err_t captureBegin();
+
+// Чтение очередного шага в кольцо (при CAPTURE_SAMPLE_RATE - после
+// ресемплера; остаток сырого входа переходит в следующий шаг) и его
+// кондиционирование на месте. Статистика кондиционированного шага
+// собирается в том же проходе и хранится вместе с шагом
+esp_err_t captureReadHop(TickType_t timeout);
+#else
+void captureHostBegin();
+
+// Шаг из HOP_LENGTH отсчетов частоты фронтенда (ресемплер не участвует):
+// то же кондиционирование, статистика и кольцо, что у шага I2S
+void captureHostHop(const int16_t* samples);
+#endif
+
+// Разрыв потока (ошибка I2S, потерянные шаги): кондиционер начинает с
+// первого отсчета следующего шага, ресемплер - с пустой линии задержки,
+// недочитанный сырой вход отбрасывается
+void captureResetStream();
+
+const int16_t* captureRing();
+
+// Число шагов, записанных с запуска
+uint32_t captureHopCount();
+
+// Индекс в кольце, с которого начинаются последние num_samples отсчетов
+int captureTailStart(int num_samples);
+
+// Индекс в кольце, с которого начинается окно из последних WINDOW_SAMPLES отсчетов
+int captureWindowStart();
+
+// Статистика шагов кольца: последние CAPTURE_RING_HOPS шагов, то есть окно
+// модели (сразу после запуска - только записанные шаги). Объем ограничен
+// кольцом, сколько бы шагов ни прошло с прошлого инференса
+void captureWindowStats(Int16Stats* stats);
+
+#ifdef ARDUINO
+// Ядро ресемплера и групповая задержка, мс (только при CAPTURE_SAMPLE_RATE)
+void reportCaptureResampler();
+#endif
+
+#endif // AUDIO_CAPTURE_H
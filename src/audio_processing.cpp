@@ -1,149 +1,197 @@
 #include "audio_processing.h"
+#include "frontend_kernels.h"
 #include <math.h>
 
-// Применение окна Ханна
-void applyHannWindow(float* buffer, int size) {
-    for (int i = 0; i < size; i++) {
-        buffer[i] *= 0.5f * (1.0f - cosf(2.0f * PI * i / (size - 1)));
-    }
+static const FrontendBackend* backend = &kScalarFrontendBackend;
+
+// Матрица DCT-II с лифтером (хотя бы одна строка и при выходе мель-энергий)
+static const int MFCC_TABLE_ROWS = NUM_MFCC > 0 ? NUM_MFCC : 1;
+static constexpr MelFilterbankTable<MFCC_TABLE_ROWS, MFCC_TABLE_ROWS * NUM_MELS> mfcc_dct =
+    makeDctFilterbank<MFCC_TABLE_ROWS, NUM_MELS, KeywordFrontendConfig::MFCC_LIFTER>();
+static constexpr MelFilterbank mfcc_filterbank = {mfcc_dct.start, mfcc_dct.length, mfcc_dct.offset,
+                                                  mfcc_dct.weights, MFCC_TABLE_ROWS};
+const float MFCC_LOG_FLOOR = 1e-6f;  // энергия пустой полосы перед логарифмом
+
+// Оценка шума по полосам: потоковый кадр ее обновляет, пересчет окна только читает
+static float mel_noise[NUM_MELS];  // сбрасывается в initFrontend
+static const MelNoiseSuppressor noise_tracker = {mel_noise, MEL_NOISE_RISE, MEL_NOISE_FALL,
+                                                 MEL_NOISE_OVERSUBTRACTION, MEL_NOISE_FLOOR, true};
+static const MelNoiseSuppressor noise_subtractor = {mel_noise, MEL_NOISE_RISE, MEL_NOISE_FALL,
+                                                    MEL_NOISE_OVERSUBTRACTION, MEL_NOISE_FLOOR, false};
+static const MelNoiseSuppressor noise_idle_tracker = {mel_noise, MEL_NOISE_RISE * MEL_NOISE_IDLE_STRIDE,
+                                                      MEL_NOISE_FALL * MEL_NOISE_IDLE_STRIDE,
+                                                      MEL_NOISE_OVERSUBTRACTION, MEL_NOISE_FLOOR, true};
+static const MelNoiseSuppressor* const window_suppressor = MEL_NOISE_SUPPRESSION ? &noise_subtractor : nullptr;
+
+void initFrontend() {
+    setFrontendBackend(selectFrontendBackend());
+    melNoiseReset();
 }
 
-// Вычисление FFT (упрощенная версия)
-void computeFFT(float* buffer, int size) {
-    float real[size];
-    float imag[size];
-    
-    // Копирование входных данных
-    for (int i = 0; i < size; i++) {
-        real[i] = buffer[i];
-        imag[i] = 0;
-    }
-    
-    // Вычисление FFT
-    for (int stage = 1; stage <= log2(size); stage++) {
-        int m = 1 << stage;
-        float wm_real = cosf(2 * PI / m);
-        float wm_imag = -sinf(2 * PI / m);
-        
-        for (int k = 0; k < size; k += m) {
-            float w_real = 1;
-            float w_imag = 0;
-            
-            for (int j = 0; j < m/2; j++) {
-                float t_real = w_real * real[k + j + m/2] - w_imag * imag[k + j + m/2];
-                float t_imag = w_real * imag[k + j + m/2] + w_imag * real[k + j + m/2];
-                
-                real[k + j + m/2] = real[k + j] - t_real;
-                imag[k + j + m/2] = imag[k + j] - t_imag;
-                real[k + j] += t_real;
-                imag[k + j] += t_imag;
-                
-                float w_next_real = w_real * wm_real - w_imag * wm_imag;
-                float w_next_imag = w_real * wm_imag + w_imag * wm_real;
-                w_real = w_next_real;
-                w_imag = w_next_imag;
-            }
-        }
-    }
-    
-    // Вычисление магнитуд
-    for (int i = 0; i < size/2; i++) {
-        buffer[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]);
+const char* frontendBackendName() {
+    return backend->name;
+}
+
+void setFrontendBackend(const FrontendBackend* frontend_backend) {
+    // Бэкенд, который не смог подготовить свои таблицы, заменяется скалярным
+    if (frontend_backend->init != nullptr && !frontend_backend->init(FFT_SIZE)) {
+        frontend_backend = &kScalarFrontendBackend;
     }
+    backend = frontend_backend;
 }
 
-// Преобразование частот в мель-шкалу
-float hzToMel(float hz) {
-    return 2595.0f * log10f(1.0f + hz / 700.0f);
+// Применение окна Ханна (результат - комплексный вход FFT)
+void applyHannWindow(const float* frame, float* fft_data) {
+    backend->window(frame, KeywordFrontend::window.data, fft_data, FFT_SIZE);
 }
 
-// Преобразование мель-шкалы в частоты
-float melToHz(float mel) {
-    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+// Вычисление FFT (radix-2 DIT) и магнитуд первой половины спектра
+void computeFFT(float* fft_data, float* fft_magnitudes) {
+    backend->fft(fft_data, KeywordFrontend::twiddles.data, KeywordFrontend::bit_reverse.data, FFT_SIZE);
+    backend->magnitude(fft_data, fft_magnitudes, FFT_SIZE / 2);
 }
 
 // Вычисление мель-фильтров
-void computeMelFilterbank(float* fft_magnitudes, float* mel_energies) {
-    float mel_min = hzToMel(MIN_FREQ);
-    float mel_max = hzToMel(MAX_FREQ);
-    float mel_step = (mel_max - mel_min) / (NUM_MELS + 1);
-    
-    // Создание точек мель-фильтров
-    float mel_points[NUM_MELS + 2];
-    for (int i = 0; i < NUM_MELS + 2; i++) {
-        mel_points[i] = mel_min + i * mel_step;
-    }
-    
-    // Преобразование точек мель-фильтров в частоты
-    float freq_points[NUM_MELS + 2];
-    for (int i = 0; i < NUM_MELS + 2; i++) {
-        freq_points[i] = melToHz(mel_points[i]);
-    }
-    
-    // Преобразование частот в индексы FFT
-    int fft_indices[NUM_MELS + 2];
-    for (int i = 0; i < NUM_MELS + 2; i++) {
-        fft_indices[i] = roundf(freq_points[i] * FFT_SIZE / SAMPLE_RATE);
-    }
-    
-    // Применение мель-фильтров
-    for (int i = 0; i < NUM_MELS; i++) {
-        mel_energies[i] = 0;
-        for (int j = fft_indices[i]; j < fft_indices[i + 2]; j++) {
-            if (j < FFT_SIZE/2) {
-                float weight = 1.0f;
-                if (j < fft_indices[i + 1]) {
-                    weight = (float)(j - fft_indices[i]) / (fft_indices[i + 1] - fft_indices[i]);
-                } else {
-                    weight = (float)(fft_indices[i + 2] - j) / (fft_indices[i + 2] - fft_indices[i + 1]);
-                }
-                mel_energies[i] += fft_magnitudes[j] * weight;
-            }
-        }
+void computeMelFilterbank(const float* fft_magnitudes, float* mel_energies) {
+    backend->melMac(fft_magnitudes, &KeywordFrontend::filterbank, mel_energies, nullptr);
+}
+
+// Один кадр: окно -> FFT -> магнитуды -> мель-энергии.
+// Вход - workspace->fft_buffer, выход - workspace->mel_energies
+void computeMelFrame(FrontendWorkspace* workspace) {
+    KeywordFrontend::computeFrame(backend, workspace);
+}
+
+void computeStreamMelFrame(FrontendWorkspace* workspace) {
+    KeywordFrontend::computeFrame(backend, workspace, MEL_NOISE_SUPPRESSION ? &noise_tracker : nullptr);
+}
+
+void updateMelNoise(FrontendWorkspace* workspace) {
+    KeywordFrontend::computeFrame(backend, workspace, &noise_idle_tracker);
+}
+
+void melNoiseReset() {
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        mel_noise[mel] = -1.0f;
     }
 }
 
 // Нормализация спектрограммы
 void normalizeSpectrogram(float* spectrogram, int size) {
-    float max_val = 0;
-    for (int i = 0; i < size; i++) {
-        if (spectrogram[i] > max_val) {
-            max_val = spectrogram[i];
-        }
+    FloatStats stats;
+    resetStats(&stats);
+    accumulateStats(spectrogram, size, SPECTROGRAM_SIGNIFICANT_LEVEL, &stats);
+    normalizeSpectrogram(spectrogram, size, stats.max, nullptr);
+}
+
+// Нормализация по заранее известному максимуму. Статистика нормализованной
+// спектрограммы собирается в том же проходе, что и деление
+void normalizeSpectrogram(float* spectrogram, int size, float max_val, FloatStats* stats) {
+    FloatStats local_stats;
+    if (stats == nullptr) {
+        stats = &local_stats;
     }
+    resetStats(stats);
     
-    if (max_val > 0) {
-        for (int i = 0; i < size; i++) {
-            spectrogram[i] /= max_val;
+    if (SPECTROGRAM_SCALE == SPECTROGRAM_LOG) {
+        // (log2(x) - log2(max)) / range + 1 с отсечением в [0, 1]. log2 максимума
+        // тем же ядром, чтобы максимум окна переходил точно в 1
+        float log_max = max_val;
+        backend->log2(&log_max, 1);
+        if (max_val <= 0) {
+            log_max = 0;
         }
+        float scale = 1.0f / SPECTROGRAM_LOG_RANGE;
+        backend->log2(spectrogram, size);
+        affineClampWithStats(spectrogram, size, scale, 1.0f - log_max * scale, 0.0f, 1.0f,
+                             SPECTROGRAM_SIGNIFICANT_LEVEL, stats);
+        return;
     }
+    float scale = (max_val > 0) ? 1.0f / max_val : 1.0f;
+    scaleWithStats(spectrogram, size, scale, SPECTROGRAM_SIGNIFICANT_LEVEL, stats);
 }
 
-// Основная функция преобразования аудио в мель-спектрограмму
-void audioToMelSpectrogram(float* audio, float* spectrogram) {
-    float fft_buffer[FFT_SIZE];
-    float mel_energies[NUM_MELS];
-    
-    for (int frame = 0; frame < NUM_FRAMES; frame++) {
-        // Копирование и применение окна
-        for (int i = 0; i < FFT_SIZE; i++) {
-            int idx = frame * HOP_LENGTH + i;
-            fft_buffer[i] = (idx < BUFFER_SIZE) ? audio[idx] : 0;
+void normalizeWindow(float* spectrogram, float max_val, FloatStats* stats) {
+    if (!FRAME_FEATURES_FINAL) {
+        normalizeSpectrogram(spectrogram, SPECTROGRAM_SIZE, max_val, stats);
+        return;
+    }
+    PcenState state;
+    pcenReset(&state);
+    float energies[NUM_MELS];
+    float frame[NUM_MELS];
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        for (int mel = 0; mel < NUM_MELS; mel++) {
+            energies[mel] = spectrogram[mel * NUM_FRAMES + f];
+        }
+        frameFeatures(&state, energies, frame);
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            spectrogram[i * NUM_FRAMES + f] = frame[i];
         }
-        applyHannWindow(fft_buffer, FFT_SIZE);
-        
-        // Вычисление FFT
-        computeFFT(fft_buffer, FFT_SIZE);
-        
-        // Применение мель-фильтров
-        computeMelFilterbank(fft_buffer, mel_energies);
-        
-        // Копирование результатов в спектрограмму
+    }
+    if (stats != nullptr) {
+        resetStats(stats);
+        accumulateStats(spectrogram, SPECTROGRAM_SIZE, SPECTROGRAM_SIGNIFICANT_LEVEL, stats);
+    }
+}
+
+void pcenReset(PcenState* state) {
+    state->primed = false;
+}
+
+void pcenFrame(PcenState* state, const float* mel_energies, float* out) {
+    if (!state->primed) {
         for (int mel = 0; mel < NUM_MELS; mel++) {
-            spectrogram[mel * NUM_FRAMES + frame] = mel_energies[mel];
+            state->smooth[mel] = mel_energies[mel];
         }
+        state->primed = true;
     }
-    
-    // Нормализация всей спектрограммы
-    normalizeSpectrogram(spectrogram, NUM_MELS * NUM_FRAMES);
-} 
\ No newline at end of file
+    // (eps + M)^-alpha = 2^(-alpha * log2(eps + M)); log2 - ядром бэкенда
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        state->smooth[mel] += PCEN_SMOOTHING * (mel_energies[mel] - state->smooth[mel]);
+        out[mel] = PCEN_EPS + state->smooth[mel];
+    }
+    backend->log2(out, NUM_MELS);
+    const float delta_root = sqrtf(PCEN_DELTA);
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        float gain = exp2f(-PCEN_ALPHA * out[mel]);
+        out[mel] = sqrtf(mel_energies[mel] * gain + PCEN_DELTA) - delta_root;
+    }
+}
+
+void mfccFrame(const float* mel_energies, float* mfcc) {
+    float log_energies[NUM_MELS];
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        log_energies[mel] = mel_energies[mel] + MFCC_LOG_FLOOR;
+    }
+    backend->log2(log_energies, NUM_MELS);
+    backend->melMac(log_energies, &mfcc_filterbank, mfcc, nullptr);
+}
+
+void frameFeatures(PcenState* state, const float* mel_energies, float* features) {
+    if (NUM_MFCC > 0) {
+        mfccFrame(mel_energies, features);
+    } else {
+        pcenFrame(state, mel_energies, features);
+    }
+}
+
+// Загрузка кадра FFT_SIZE из кольцевого буфера с преобразованием int16 -> float
+void loadFrame(const int16_t* audio, int audio_size, int start, float* frame) {
+    KeywordFrontend::loadFrame(audio, audio_size, start, frame);
+}
+
+// Основная функция преобразования аудио в мель-спектрограмму
+void audioToMelSpectrogram(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                           FrontendWorkspace* workspace, FloatStats* stats) {
+    // Кадры окна (максимум считается попутно), затем нормализация всей спектрограммы
+    float max_val = KeywordFrontend::computeSpectrogram(backend, audio, audio_size, start, spectrogram, workspace,
+                                                        window_suppressor);
+    normalizeWindow(spectrogram, max_val, stats);
+}
+
+float audioToMelFrames(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                       FrontendWorkspace* workspace, int first_frame, int end_frame) {
+    return KeywordFrontend::computeFrames(backend, audio, audio_size, start, spectrogram, workspace,
+                                          first_frame, end_frame, window_suppressor);
+}
@@ -1,25 +1,208 @@
 #ifndef AUDIO_PROCESSING_H
 #define AUDIO_PROCESSING_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+// Сборка на хосте (обработка записей на шлюзе)
+#include <stdint.h>
+#include <stddef.h>
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#endif
+#include "signal_stats.h"
+#include "mel_frontend.h"
+
+// Шкала выхода фронтенда. LINEAR - мель-энергии, деленные на максимум окна
+// (на этом обучена текущая модель). LOG - log2 энергии относительно максимума
+// окна, диапазон SPECTROGRAM_LOG_RANGE_DB приводится к [0, 1]: равномерный
+// шаг в дБ вместо линейного, пригодный для квантования входа int8 модели.
+// Включается флагом сборки -DFRONTEND_LOG_MEL (модель обучается на той же шкале)
+enum SpectrogramScale {
+    SPECTROGRAM_LINEAR,
+    SPECTROGRAM_LOG
+};
+
+// Нормализация спектрограммы. WINDOW_MAX - деление на максимум окна: нужно
+// все окно, кадр меняется, пока он в окне. PCEN (per-channel energy
+// normalization) - каждый кадр делится на сглаженную во времени энергию
+// своей полосы, состояние переносится от кадра к кадру, и кадр окончателен
+// сразу после вычисления (mel_stream.h). PCEN сам сжимает динамический
+// диапазон (корень), поэтому шкала SCALE с ним не используется.
+// Включается флагом сборки -DFRONTEND_PCEN
+enum SpectrogramNormalization {
+    NORMALIZE_WINDOW_MAX,
+    NORMALIZE_PCEN
+};
+
+// Выход MFCC (-DFRONTEND_MFCC=13): после мель-банка - log2 энергий и DCT-II
+// (mel_frontend.h, makeDctFilterbank) с лифтером FRONTEND_MFCC_LIFTER
+// (по умолчанию 22, 0 - без лифтера). Кадр из NUM_MFCC коэффициентов
+// окончателен сразу, нормализация по окну и шкала SCALE не применяются.
+// NUM_MFCC = 0 - выход мель-энергий
+
+// Вычитание стационарного шума в мель-области (-DFRONTEND_NOISE_SUPPRESSION):
+// оценка шума каждой полосы и вычитание с порогом снизу выполняются ядром
+// melMac сразу после суммы полосы (MelNoiseSuppressor, frontend_kernels.h).
+// Оценку ведет потоковый фронтенд по каждому новому кадру; полный пересчет
+// окна только вычитает текущую оценку (кадры считаются на двух ядрах)
+
+// Параметры фронтенда ключевых слов (вход модели)
+struct KeywordFrontendConfig {
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int FFT_SIZE = 512;
+    static constexpr int NUM_MELS = 40;
+    static constexpr int NUM_FRAMES = 49;
+    static constexpr int HOP_LENGTH = 160;
+    static constexpr int MIN_FREQ = 20;
+    static constexpr int MAX_FREQ = 8000;
+#ifdef FRONTEND_LOG_MEL
+    static constexpr SpectrogramScale SCALE = SPECTROGRAM_LOG;
+#else
+    static constexpr SpectrogramScale SCALE = SPECTROGRAM_LINEAR;
+#endif
+#ifdef FRONTEND_PCEN
+    static constexpr SpectrogramNormalization NORMALIZATION = NORMALIZE_PCEN;
+#else
+    static constexpr SpectrogramNormalization NORMALIZATION = NORMALIZE_WINDOW_MAX;
+#endif
+#ifdef FRONTEND_MFCC
+    static constexpr int NUM_MFCC = FRONTEND_MFCC;
+#else
+    static constexpr int NUM_MFCC = 0;
+#endif
+#ifdef FRONTEND_MFCC_LIFTER
+    static constexpr int MFCC_LIFTER = FRONTEND_MFCC_LIFTER;
+#else
+    static constexpr int MFCC_LIFTER = 22;
+#endif
+#ifdef FRONTEND_NOISE_SUPPRESSION
+    static constexpr bool NOISE_SUPPRESSION = true;
+#else
+    static constexpr bool NOISE_SUPPRESSION = false;
+#endif
+};
+
+static_assert(KeywordFrontendConfig::NORMALIZATION != NORMALIZE_PCEN ||
+              KeywordFrontendConfig::SCALE == SPECTROGRAM_LINEAR,
+              "PCEN сжимает диапазон сам, логарифмическая шкала с ним не нужна");
+static_assert(KeywordFrontendConfig::NUM_MFCC >= 0 &&
+              KeywordFrontendConfig::NUM_MFCC <= KeywordFrontendConfig::NUM_MELS,
+              "коэффициентов MFCC не больше числа мель-полос");
+static_assert(KeywordFrontendConfig::NUM_MFCC == 0 ||
+              (KeywordFrontendConfig::NORMALIZATION == NORMALIZE_WINDOW_MAX &&
+               KeywordFrontendConfig::SCALE == SPECTROGRAM_LINEAR),
+              "MFCC логарифмируют энергии сами, PCEN и логарифмическая шкала с ними не используются");
+
+typedef MelFrontend<KeywordFrontendConfig> KeywordFrontend;
 
 // Константы для обработки аудио
-const int SAMPLE_RATE = 16000;
-const int FFT_SIZE = 512;
-const int NUM_MELS = 40;
-const int NUM_FRAMES = 49;
-const int HOP_LENGTH = 160;
+const int SAMPLE_RATE = KeywordFrontend::SAMPLE_RATE;
+const int FFT_SIZE = KeywordFrontend::FFT_SIZE;
+const int NUM_MELS = KeywordFrontend::NUM_MELS;
+const int NUM_FRAMES = KeywordFrontend::NUM_FRAMES;
+const int HOP_LENGTH = KeywordFrontend::HOP_LENGTH;
 const int BUFFER_SIZE = NUM_FRAMES * HOP_LENGTH + FFT_SIZE;
-const int MIN_FREQ = 20;
-const int MAX_FREQ = 8000;
-
-// Функции обработки аудио
-void applyHannWindow(float* buffer, int size);
-void computeFFT(float* buffer, int size);
-float hzToMel(float hz);
-float melToHz(float mel);
-void computeMelFilterbank(float* fft_magnitudes, float* mel_energies);
+const int WINDOW_SAMPLES = KeywordFrontend::WINDOW_SAMPLES;  // Отсчеты, покрываемые кадрами окна
+const int MIN_FREQ = KeywordFrontendConfig::MIN_FREQ;
+const int MAX_FREQ = KeywordFrontendConfig::MAX_FREQ;
+const int NUM_MFCC = KeywordFrontendConfig::NUM_MFCC;
+const int NUM_FEATURES = NUM_MFCC > 0 ? NUM_MFCC : NUM_MELS;   // признаков в кадре (вход модели)
+const int MEL_SPECTROGRAM_SIZE = KeywordFrontend::SPECTROGRAM_SIZE;  // 40 * 49, буфер полного пересчета
+const int SPECTROGRAM_SIZE = NUM_FEATURES * NUM_FRAMES;         // вход модели, начало того же буфера
+
+// Признаки кадра окончательны сразу после его вычисления (PCEN или MFCC):
+// потоковый фронтенд хранит в кольце готовые кадры
+const bool FRAME_FEATURES_FINAL = KeywordFrontendConfig::NORMALIZATION == NORMALIZE_PCEN || NUM_MFCC > 0;
+
+const SpectrogramScale SPECTROGRAM_SCALE = KeywordFrontendConfig::SCALE;
+const float SPECTROGRAM_LOG_RANGE_DB = 80.0f;
+const float SPECTROGRAM_LOG_RANGE = SPECTROGRAM_LOG_RANGE_DB / 6.0206f;  // в октавах (20 * log10(2) дБ)
+
+// PCEN: M = M + s * (E - M); выход = sqrt(E / (eps + M)^alpha + delta) - sqrt(delta)
+const SpectrogramNormalization SPECTROGRAM_NORMALIZATION = KeywordFrontendConfig::NORMALIZATION;
+const float PCEN_SMOOTHING = 0.025f;  // s, постоянная времени ~0.4 с при шаге 10 мс
+const float PCEN_ALPHA = 0.98f;
+const float PCEN_DELTA = 2.0f;
+const float PCEN_EPS = 1e-6f;
+
+// Состояние PCEN - сглаженная энергия каждой полосы
+struct PcenState {
+    float smooth[NUM_MELS];
+    bool primed;                      // первый кадр задает начальное сглаживание
+};
+
+// Вычитание шума: подъем оценки медленный (события ее почти не сдвигают),
+// спуск к паузам быстрый
+const bool MEL_NOISE_SUPPRESSION = KeywordFrontendConfig::NOISE_SUPPRESSION;
+const float MEL_NOISE_RISE = 0.002f;          // ~5 с при шаге 10 мс
+const float MEL_NOISE_FALL = 0.05f;           // ~0.2 с
+const float MEL_NOISE_OVERSUBTRACTION = 1.5f;
+const float MEL_NOISE_FLOOR = 0.1f;           // остаток не ниже -20 дБ от энергии полосы
+// Пока поток кадров стоит (простой банка Герцеля), оценка обновляется раз
+// в MEL_NOISE_IDLE_STRIDE шагов с постоянными, умноженными на тот же шаг
+const int MEL_NOISE_IDLE_STRIDE = 4;
+
+// Порог "значимого" значения нормализованной спектрограммы для статистики
+const float SPECTROGRAM_SIGNIFICANT_LEVEL = 0.001f;
+
+// Рабочая память фронтенда. Живет только во время audioToMelSpectrogram,
+// поэтому размещается вызывающей стороной (см. memory_plan.h), а не на стеке
+typedef KeywordFrontend::Workspace FrontendWorkspace;
+
+// Выбор вычислительного бэкенда. Таблицы фронтенда (окно, поворачивающие
+// множители, мель-веса) строятся при компиляции, см. mel_frontend.h.
+// Вызывается один раз до обработки аудио
+void initFrontend();
+const char* frontendBackendName();
+
+// Принудительный выбор бэкенда (сравнение бэкендов и эталон на хосте)
+void setFrontendBackend(const FrontendBackend* frontend_backend);
+
+// Функции обработки аудио. Вход фронтенда - кольцевой буфер int16 размером
+// audio_size; окно начинается с отсчета start (линейный буфер - частный случай)
+void applyHannWindow(const float* frame, float* fft_data);
+void computeFFT(float* fft_data, float* fft_magnitudes);
+void computeMelFilterbank(const float* fft_magnitudes, float* mel_energies);
+void computeMelFrame(FrontendWorkspace* workspace);
+// Кадр потокового фронтенда: при MEL_NOISE_SUPPRESSION - с обновлением
+// оценки шума и вычитанием, иначе как computeMelFrame
+void computeStreamMelFrame(FrontendWorkspace* workspace);
+// Только обновление оценки шума по кадру в workspace->fft_buffer (простой
+// потока, раз в MEL_NOISE_IDLE_STRIDE шагов); мель-энергии не используются
+void updateMelNoise(FrontendWorkspace* workspace);
+// Сброс оценки шума (следующий кадр потока задает ее заново)
+void melNoiseReset();
 void normalizeSpectrogram(float* spectrogram, int size);
-void audioToMelSpectrogram(float* audio, float* spectrogram);
+// Нормализация по заранее известному максимуму окна в шкале SPECTROGRAM_SCALE
+// (подходит и для отдельного кадра)
+void normalizeSpectrogram(float* spectrogram, int size, float max_val, FloatStats* stats);
+// Нормализация окна (раскладка mel * NUM_FRAMES + frame, MEL_SPECTROGRAM_SIZE)
+// по SPECTROGRAM_NORMALIZATION. В режиме PCEN кадры окна проходят по порядку
+// от нового состояния: так считается окно без потокового кольца кадров.
+// В режиме MFCC кадры заменяются на месте: коэффициент k кадра f ложится
+// на место мель-полосы k того же кадра, результат - первые SPECTROGRAM_SIZE
+void normalizeWindow(float* spectrogram, float max_val, FloatStats* stats);
+
+// Мель-энергии кадра -> NUM_MFCC коэффициентов
+void mfccFrame(const float* mel_energies, float* mfcc);
+
+// Признаки кадра при FRAME_FEATURES_FINAL (PCEN или MFCC)
+void frameFeatures(PcenState* state, const float* mel_energies, float* features);
+
+void pcenReset(PcenState* state);
+
+// Кадр мель-энергий -> кадр PCEN (out не совпадает с mel_energies)
+void pcenFrame(PcenState* state, const float* mel_energies, float* out);
+
+void loadFrame(const int16_t* audio, int audio_size, int start, float* frame);
+void audioToMelSpectrogram(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                           FrontendWorkspace* workspace, FloatStats* stats = nullptr);
+
+// Кадры [first_frame, end_frame) окна без нормализации, возвращает их максимум.
+// Для разбиения окна между ядрами (см. frontend_parallel.h)
+float audioToMelFrames(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                       FrontendWorkspace* workspace, int first_frame, int end_frame);
 
 #endif // AUDIO_PROCESSING_H 
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "boot_profile.h"
+#include "alloc_tracker.h"
+#include "diagnostics.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <Preferences.h>
+
+static const char* const stage_names[BOOT_STAGE_COUNT] = {
+    "setup()", "захват запущен", "модель готова", "окно заполнено", "первый инференс"};
+
+static uint32_t s_stage_us[BOOT_STAGE_COUNT];
+static bool s_stage_marked[BOOT_STAGE_COUNT];
+static BootPlanRecord s_loaded_plan;
+static bool s_plan_loaded = false;
+static BootPlanRecord s_plan;
+static bool s_plan_set = false;
+static void (*s_report)() = nullptr;
+static TaskHandle_t s_report_task = nullptr;
+
+void bootMark(BootStage stage) {
+    if (s_stage_marked[stage]) {
+        return;
+    }
+    s_stage_us[stage] = micros();
+    s_stage_marked[stage] = true;
+    if (stage == BOOT_FIRST_INFERENCE) {
+        TaskHandle_t task = __atomic_exchange_n(&s_report_task, nullptr, __ATOMIC_ACQ_REL);
+        if (task != nullptr) {
+            xTaskNotifyGive(task);
+        }
+    }
+}
+
+bool bootPlanLoad(BootPlanRecord* record) {
+    Preferences prefs;
+    if (!prefs.begin("boot_plan", true)) {
+        return false;
+    }
+    s_plan_loaded = prefs.getBytes("plan", &s_loaded_plan, sizeof(s_loaded_plan)) == sizeof(s_loaded_plan);
+    prefs.end();
+    if (s_plan_loaded) {
+        *record = s_loaded_plan;
+    }
+    return s_plan_loaded;
+}
+
+void bootPlanSet(const BootPlanRecord& record) {
+    s_plan = record;
+    s_plan_set = true;
+}
+
+// План сохраняется, только если модель или раскладка изменились
+static void storePlan() {
+    if (!s_plan_set || (s_plan_loaded && s_loaded_plan.model_fingerprint == s_plan.model_fingerprint &&
+                        s_loaded_plan.arena_used == s_plan.arena_used)) {
+        return;
+    }
+    Preferences prefs;
+    if (prefs.begin("boot_plan", false)) {
+        prefs.putBytes("plan", &s_plan, sizeof(s_plan));
+        prefs.end();
+    }
+}
+
+static void reportBootStages() {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== БЫСТРЫЙ СТАРТ ===");
+    for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+        Serial.print(stage_names[stage]); Serial.print(": ");
+        if (s_stage_marked[stage]) {
+            Serial.print(s_stage_us[stage] / 1000); Serial.println(" мс");
+        } else {
+            Serial.println("-");
+        }
+    }
+    if (s_plan_set) {
+        Serial.print("Арена: "); Serial.print(s_plan.arena_used);
+        Serial.print(" байт, загрузка модели "); Serial.print(s_plan.load_us); Serial.println(" мкс");
+    }
+    if (s_plan_set && s_plan_loaded) {
+        bool same = s_loaded_plan.model_fingerprint == s_plan.model_fingerprint &&
+                    s_loaded_plan.arena_used == s_plan.arena_used;
+        Serial.print("План прошлой загрузки: ");
+        Serial.print(same ? "совпал" : "изменился");
+        Serial.print(", загрузка тогда "); Serial.print(s_loaded_plan.load_us); Serial.println(" мкс");
+    }
+#endif
+}
+
+static void bootReportTask(void* arg) {
+    // Дескриптор задачи забирает кто-то один. Если по таймауту его уже забрал
+    // loop(), уведомление обязательно придет: задачу нельзя удалять раньше
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BOOT_REPORT_TIMEOUT_MS));
+    if (notified == 0 && __atomic_exchange_n(&s_report_task, nullptr, __ATOMIC_ACQ_REL) == nullptr) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    stackBudgetBegin();
+    reportBootStages();
+    storePlan();
+    if (s_report != nullptr) {
+        s_report();
+    }
+    stackBudgetEnd();
+    stackBudgetUnregisterCurrentTask();
+    vTaskDelete(nullptr);
+}
+
+bool bootReportBegin(void (*report)()) {
+    s_report = report;
+    BaseType_t created = xTaskCreatePinnedToCore(bootReportTask, "boot_report", BOOT_REPORT_STACK_SIZE, nullptr,
+                                                 BOOT_REPORT_PRIORITY, &s_report_task, BOOT_REPORT_CORE);
+    if (created != pdPASS) {
+        s_report_task = nullptr;
+        return false;
+    }
+    stackBudgetRegisterTask(s_report_task, BOOT_REPORT_STACK_SIZE, BOOT_REPORT_STACK_BUDGET);
+    return true;
+}
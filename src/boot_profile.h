@@ -0,0 +1,54 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// Быстрый старт (сборка с -DFAST_BOOT): setup() не ждет USB Serial, захват
+// запускается до загрузки модели, а информация о модели, тесты бэкендов и
+// микрофона не выполняются при загрузке. Отчет печатает фоновая задача после
+// первого инференса (или по таймауту, если звука не было).
+// Время этапов загрузки отсчитывается от старта приложения.
+//
+// Запись плана тензоров в NVS: отпечаток модели, занятые байты арены и время
+// загрузки модели с AllocateTensors() при первом старте. Запись не ускоряет
+// загрузку: TFLM этой версии не принимает готовую раскладку тензоров
+// (офлайн-план читается только из метаданных flatbuffer), и AllocateTensors()
+// каждый раз планирует арену заново. Запись служит только для отчета - план
+// и время загрузки сравниваются с прошлой загрузкой
+
+enum BootStage {
+    BOOT_SETUP_START,
+    BOOT_CAPTURE_STARTED,
+    BOOT_MODEL_READY,
+    BOOT_WINDOW_READY,                           // кольцо мель-кадров впервые заполнено
+    BOOT_FIRST_INFERENCE,
+    BOOT_STAGE_COUNT
+};
+
+const uint32_t BOOT_REPORT_TIMEOUT_MS = 10000;   // отчет без инференса, если звука не было
+const uint32_t BOOT_REPORT_STACK_SIZE = 4096;    // байт, вывод и запись NVS
+const uint32_t BOOT_REPORT_STACK_BUDGET = 3072;  // байт на отчет (alloc_tracker.h)
+const UBaseType_t BOOT_REPORT_PRIORITY = 1;
+const BaseType_t BOOT_REPORT_CORE = 0;
+
+struct BootPlanRecord {
+    uint32_t model_fingerprint;                  // CRC образа модели или отпечаток прошивки
+    uint32_t arena_used;                         // байт арены после AllocateTensors()
+    uint32_t load_us;                            // загрузка модели с AllocateTensors() при записи
+};
+
+// Отметка этапа (только первая отметка каждого этапа)
+void bootMark(BootStage stage);
+
+// Запись плана прошлой загрузки. false - записи нет
+bool bootPlanLoad(BootPlanRecord* record);
+
+// План текущей загрузки; сохраняется в NVS фоновой задачей, если отличается
+// от загруженного (запись во флеш не задерживает старт)
+void bootPlanSet(const BootPlanRecord& record);
+
+// Фоновая задача отчета: ждет BOOT_FIRST_INFERENCE (или таймаут), печатает
+// этапы загрузки, сохраняет план и вызывает report, затем завершается
+bool bootReportBegin(void (*report)());
+
+#endif // BOOT_PROFILE_H
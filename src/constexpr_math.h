@@ -0,0 +1,101 @@
+#ifndef CONSTEXPR_MATH_H
+#define CONSTEXPR_MATH_H
+
+// Элементарные функции, вычисляемые при компиляции (C++17 constexpr).
+// Используются только для генерации таблиц фронтенда; точность - двойная,
+// результат приводится к float при записи в таблицу.
+
+constexpr double CONSTEXPR_PI = 3.14159265358979323846;
+constexpr double CONSTEXPR_LN2 = 0.69314718055994530942;
+constexpr double CONSTEXPR_LN10 = 2.30258509299404568402;
+
+constexpr double constexprAbs(double x) {
+    return x < 0 ? -x : x;
+}
+
+// Округление половин от нуля, как roundf
+constexpr int constexprRound(double x) {
+    return x < 0 ? -(int)(-x + 0.5) : (int)(x + 0.5);
+}
+
+// Ряд Тейлора для sin/cos после приведения аргумента к [-pi, pi]
+constexpr double constexprReduceAngle(double x) {
+    double turns = x / (2 * CONSTEXPR_PI);
+    long long k = (long long)(turns < 0 ? turns - 0.5 : turns + 0.5);
+    return x - k * 2 * CONSTEXPR_PI;
+}
+
+constexpr double constexprSin(double x) {
+    x = constexprReduceAngle(x);
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 40 && constexprAbs(term) > 1e-20; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constexprCos(double x) {
+    x = constexprReduceAngle(x);
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 40 && constexprAbs(term) > 1e-20; n++) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// ln(x) = k * ln2 + 2 * atanh((m - 1) / (m + 1)), x = m * 2^k, m в [1, 2)
+constexpr double constexprLog(double x) {
+    int k = 0;
+    while (x >= 2) {
+        x /= 2;
+        k++;
+    }
+    while (x < 1) {
+        x *= 2;
+        k--;
+    }
+    double y = (x - 1) / (x + 1);
+    double y2 = y * y;
+    double term = y;
+    double sum = 0;
+    for (int n = 1; n < 200 && constexprAbs(term) > 1e-20; n += 2) {
+        sum += term / n;
+        term *= y2;
+    }
+    return k * CONSTEXPR_LN2 + 2 * sum;
+}
+
+// constexprExp(x) = 2^k * constexprExp(r), |r| <= ln2 / 2
+constexpr double constexprExp(double x) {
+    int k = constexprRound(x / CONSTEXPR_LN2);
+    double r = x - k * CONSTEXPR_LN2;
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 40 && constexprAbs(term) > 1e-20; n++) {
+        term *= r / n;
+        sum += term;
+    }
+    while (k > 0) {
+        sum *= 2;
+        k--;
+    }
+    while (k < 0) {
+        sum /= 2;
+        k++;
+    }
+    return sum;
+}
+
+constexpr double constexprLog10(double x) {
+    return constexprLog(x) / CONSTEXPR_LN10;
+}
+
+constexpr double constexprPow10(double x) {
+    return constexprExp(x * CONSTEXPR_LN10);
+}
+
+#endif // CONSTEXPR_MATH_H
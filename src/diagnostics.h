@@ -0,0 +1,53 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <Arduino.h>
+
+// Уровни диагностики. Уровень задается при компиляции флагом -DDIAG_LEVEL=N
+// (см. platformio.ini). Все, что выше выбранного уровня, вырезается
+// препроцессором: циклы статистики, строки и вызовы Serial не попадают в прошивку.
+#define DIAG_LEVEL_NONE    0  // Никакого вывода
+#define DIAG_LEVEL_ERROR   1  // Сообщения об ошибках
+#define DIAG_LEVEL_RESULT  2  // Продакшн: ошибки и итог распознавания
+#define DIAG_LEVEL_INFO    3  // Информация о модели, оценки классов и тайминги окна
+#define DIAG_LEVEL_VERBOSE 4  // Статистика аудио и спектрограммы на каждом окне
+
+#ifndef DIAG_LEVEL
+#define DIAG_LEVEL DIAG_LEVEL_VERBOSE
+#endif
+
+#define DIAG_ENABLED(level) (DIAG_LEVEL >= (level))
+
+#if DIAG_ENABLED(DIAG_LEVEL_ERROR)
+#define DIAG_ERROR(...)   Serial.print(__VA_ARGS__)
+#define DIAG_ERRORLN(...) Serial.println(__VA_ARGS__)
+#else
+#define DIAG_ERROR(...)   do {} while (0)
+#define DIAG_ERRORLN(...) do {} while (0)
+#endif
+
+#if DIAG_ENABLED(DIAG_LEVEL_RESULT)
+#define DIAG_RESULT(...)   Serial.print(__VA_ARGS__)
+#define DIAG_RESULTLN(...) Serial.println(__VA_ARGS__)
+#else
+#define DIAG_RESULT(...)   do {} while (0)
+#define DIAG_RESULTLN(...) do {} while (0)
+#endif
+
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+#define DIAG_INFO(...)    Serial.print(__VA_ARGS__)
+#define DIAG_INFOLN(...)  Serial.println(__VA_ARGS__)
+#else
+#define DIAG_INFO(...)    do {} while (0)
+#define DIAG_INFOLN(...)  do {} while (0)
+#endif
+
+#if DIAG_ENABLED(DIAG_LEVEL_VERBOSE)
+#define DIAG_VERBOSE(...)   Serial.print(__VA_ARGS__)
+#define DIAG_VERBOSELN(...) Serial.println(__VA_ARGS__)
+#else
+#define DIAG_VERBOSE(...)   do {} while (0)
+#define DIAG_VERBOSELN(...) do {} while (0)
+#endif
+
+#endif // DIAGNOSTICS_H
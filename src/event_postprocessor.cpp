@@ -0,0 +1,80 @@
+#include "event_postprocessor.h"
+#include <math.h>
+
+void resetEventPostprocessor(EventPostprocessor* postprocessor) {
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        ClassTrack& track = postprocessor->classes[i];
+        track.smoothed = 0;
+        track.peak = 0;
+        track.active = false;
+        track.start_hop = 0;
+        track.refractory_until = 0;
+    }
+    postprocessor->last_hop = 0;
+    postprocessor->primed = false;
+}
+
+// Конец события при сглаженной оценке ниже порога
+static void endEvent(ClassTrack& track, int class_index, uint32_t hop, EventRecord* record) {
+    track.active = false;
+    track.refractory_until = hop + EVENT_REFRACTORY_HOPS;
+    record->class_index = class_index;
+    record->start = false;
+    record->hop = hop;
+    record->duration_hops = hop - track.start_hop;
+    record->score = track.peak;
+}
+
+int eventPostprocessorUpdate(EventPostprocessor* postprocessor, const float* scores, uint32_t hop,
+                             EventRecord* records) {
+    // Первое окно задает начальное состояние без сглаживания
+    float alpha = 1.0f;
+    if (postprocessor->primed) {
+        uint32_t dt = hop - postprocessor->last_hop;
+        dt = dt < EVENT_HOLD_HOPS ? dt : EVENT_HOLD_HOPS;
+        alpha = 1.0f - expf(-(float)dt / EVENT_SMOOTHING_HOPS);
+    }
+    postprocessor->primed = true;
+    postprocessor->last_hop = hop;
+
+    int count = 0;
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        ClassTrack& track = postprocessor->classes[i];
+        track.smoothed += alpha * (scores[i] - track.smoothed);
+
+        if (track.active) {
+            track.peak = track.smoothed > track.peak ? track.smoothed : track.peak;
+            if (track.smoothed < EVENT_OFF_THRESHOLD) {
+                endEvent(track, i, hop, &records[count++]);
+            }
+        } else if (track.smoothed >= EVENT_ON_THRESHOLD && (int32_t)(hop - track.refractory_until) >= 0) {
+            track.active = true;
+            track.start_hop = hop;
+            track.peak = track.smoothed;
+            EventRecord& record = records[count++];
+            record.class_index = i;
+            record.start = true;
+            record.hop = hop;
+            record.duration_hops = 0;
+            record.score = track.smoothed;
+        }
+    }
+    return count;
+}
+
+int eventPostprocessorTick(EventPostprocessor* postprocessor, uint32_t hop, EventRecord* records) {
+    if (!postprocessor->primed || hop - postprocessor->last_hop <= EVENT_HOLD_HOPS) {
+        return 0;
+    }
+    // Один шаг сглаживания с нулевой оценкой
+    const float decay = expf(-1.0f / EVENT_SMOOTHING_HOPS);
+    int count = 0;
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        ClassTrack& track = postprocessor->classes[i];
+        track.smoothed *= decay;
+        if (track.active && track.smoothed < EVENT_OFF_THRESHOLD) {
+            endEvent(track, i, hop, &records[count++]);
+        }
+    }
+    return count;
+}
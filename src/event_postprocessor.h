@@ -0,0 +1,66 @@
+#ifndef EVENT_POSTPROCESSOR_H
+#define EVENT_POSTPROCESSOR_H
+
+#include <stdint.h>
+#include "audio_processing.h"
+
+// Потоковая постобработка оценок классов: экспоненциальное сглаживание
+// по окнам, гистерезис и период рефрактерности по каждому классу.
+// На выходе - дискретные записи о начале и конце события вместо решения
+// по argmax одного окна. Окна приходят нерегулярно (онсеты, прореживание),
+// поэтому коэффициент сглаживания зависит от числа шагов между окнами:
+//   alpha = 1 - exp(-min(dt, EVENT_HOLD_HOPS) / EVENT_SMOOTHING_HOPS)
+// Окно дальше EVENT_HOLD_HOPS шагов не делит аудио с прошлым и весит не
+// больше 1 - exp(-HOLD / SMOOTHING). Оценки окна действуют EVENT_HOLD_HOPS
+// шагов; если нового окна нет дольше, eventPostprocessorTick на каждом шаге
+// считает оценки нулевыми: сглаженные оценки затухают, и событие
+// заканчивается без следующего окна.
+// Время - номер шага захвата (время аудио, а не millis()).
+// Не зависит от Arduino - пороги настраиваются на записях на хосте
+
+const int NUM_CLASSES = 3;
+
+const float EVENT_SMOOTHING_HOPS = 15.0f;    // постоянная времени, шагов (150 мс)
+const float EVENT_ON_THRESHOLD = 0.6f;       // начало события
+const float EVENT_OFF_THRESHOLD = 0.3f;      // конец события
+const uint32_t EVENT_REFRACTORY_HOPS = 100;  // 1 с после конца события класса
+const uint32_t EVENT_HOLD_HOPS = NUM_FRAMES; // оценки окна действуют одно окно
+
+// Не больше одной записи на класс за окно или шаг
+const int EVENT_MAX_RECORDS = NUM_CLASSES;
+
+struct EventRecord {
+    int class_index;
+    bool start;                 // true - начало, false - конец
+    uint32_t hop;               // шаг захвата, на котором принято решение
+    uint32_t duration_hops;     // для конца: длительность события
+    float score;                // сглаженная оценка (для конца - пиковая)
+};
+
+struct ClassTrack {
+    float smoothed;
+    float peak;
+    bool active;
+    uint32_t start_hop;
+    uint32_t refractory_until;
+};
+
+struct EventPostprocessor {
+    ClassTrack classes[NUM_CLASSES];
+    uint32_t last_hop;
+    bool primed;
+};
+
+void resetEventPostprocessor(EventPostprocessor* postprocessor);
+
+// Оценки очередного окна, окно заканчивается на шаге hop. Записи о
+// событиях пишутся в records (не больше EVENT_MAX_RECORDS), возвращается их число
+int eventPostprocessorUpdate(EventPostprocessor* postprocessor, const float* scores, uint32_t hop,
+                             EventRecord* records);
+
+// Вызывается на каждом шаге: после EVENT_HOLD_HOPS шагов без окна оценки
+// затухают как при нулевых оценках, активные события заканчиваются по
+// порогу. Записи - как у eventPostprocessorUpdate
+int eventPostprocessorTick(EventPostprocessor* postprocessor, uint32_t hop, EventRecord* records);
+
+#endif // EVENT_POSTPROCESSOR_H
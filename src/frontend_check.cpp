@@ -0,0 +1,171 @@
+#include "frontend_check.h"
+#include "frontend_kernels.h"
+#include "frontend_parallel.h"
+#include "diagnostics.h"
+#include <math.h>
+#include <string.h>
+
+const int FRONTEND_CHECK_RUNS = 20;
+const int FRONTEND_CHECK_MAX_BACKENDS = 4;
+const int FRONTEND_CHECK_WINDOW_RUNS = 5;
+
+// Детерминированный тестовый кадр: две синусоиды и псевдослучайный шум
+static void fillTestFrame(float* frame) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((int32_t)(seed >> 16) - 32768) / 327680.0f;
+        frame[i] = 0.3f * sinf(0.07f * i) + 0.1f * sinf(1.3f * i) + noise;
+    }
+}
+
+// Такты на один кадр (окно + FFT + магнитуды + мель), среднее по прогонам
+static uint32_t measureFrameCycles(FrontendWorkspace* workspace) {
+    uint32_t total = 0;
+    for (int run = 0; run < FRONTEND_CHECK_RUNS; run++) {
+        fillTestFrame(workspace->fft_buffer);
+        uint32_t start = ESP.getCycleCount();
+        computeMelFrame(workspace);
+        total += ESP.getCycleCount() - start;
+    }
+    return total / FRONTEND_CHECK_RUNS;
+}
+
+// Такты log2 мель-энергий кадра ядром бэкенда (или libm при backend == nullptr)
+// и максимальная абсолютная ошибка ядра относительно log2f
+static uint32_t measureLogCycles(const FrontendBackend* backend, const float* mel_energies, float* max_error) {
+    float values[NUM_MELS];
+    uint32_t total = 0;
+    for (int run = 0; run < FRONTEND_CHECK_RUNS; run++) {
+        memcpy(values, mel_energies, sizeof(values));
+        uint32_t start = ESP.getCycleCount();
+        if (backend != nullptr) {
+            backend->log2(values, NUM_MELS);
+        } else {
+            for (int i = 0; i < NUM_MELS; i++) {
+                values[i] = log2f(values[i]);
+            }
+        }
+        total += ESP.getCycleCount() - start;
+    }
+    *max_error = 0;
+    for (int i = 0; i < NUM_MELS; i++) {
+        float err = fabsf(values[i] - log2f(mel_energies[i]));
+        *max_error = err > *max_error ? err : *max_error;
+    }
+    return total / FRONTEND_CHECK_RUNS;
+}
+
+// Такты, добавляемые к MAC мель-фильтров кадра вычитанием шума с обновлением
+// оценки (как в потоковом фронтенде; оценка локальная, общая не меняется)
+static int32_t measureNoiseCycles(const FrontendBackend* backend, const float* magnitudes) {
+    float noise[NUM_MELS];
+    float mel_energies[NUM_MELS];
+    for (int i = 0; i < NUM_MELS; i++) {
+        noise[i] = -1.0f;
+    }
+    const MelNoiseSuppressor suppressor = {noise, MEL_NOISE_RISE, MEL_NOISE_FALL,
+                                           MEL_NOISE_OVERSUBTRACTION, MEL_NOISE_FLOOR, true};
+    uint32_t plain = 0;
+    uint32_t suppressed = 0;
+    for (int run = 0; run < FRONTEND_CHECK_RUNS; run++) {
+        uint32_t start = ESP.getCycleCount();
+        backend->melMac(magnitudes, &KeywordFrontend::filterbank, mel_energies, nullptr);
+        plain += ESP.getCycleCount() - start;
+        start = ESP.getCycleCount();
+        backend->melMac(magnitudes, &KeywordFrontend::filterbank, mel_energies, &suppressor);
+        suppressed += ESP.getCycleCount() - start;
+    }
+    return ((int32_t)suppressed - (int32_t)plain) / FRONTEND_CHECK_RUNS;
+}
+
+void reportFrontendBackends(FrontendWorkspace* workspace) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    const char* selected_name = frontendBackendName();
+    const FrontendBackend* selected = findFrontendBackend(selected_name);
+    
+    // Скалярный эталон
+    float reference[NUM_MELS];
+    setFrontendBackend(&kScalarFrontendBackend);
+    fillTestFrame(workspace->fft_buffer);
+    computeMelFrame(workspace);
+    for (int i = 0; i < NUM_MELS; i++) {
+        reference[i] = workspace->mel_energies[i];
+    }
+    float libm_error = 0;
+    uint32_t libm_log_cycles = measureLogCycles(nullptr, reference, &libm_error);
+    
+    Serial.println("\n=== БЭКЕНДЫ ФРОНТЕНДА ===");
+    const FrontendBackend* backends[FRONTEND_CHECK_MAX_BACKENDS];
+    int count = availableFrontendBackends(backends, FRONTEND_CHECK_MAX_BACKENDS);
+    for (int b = 0; b < count; b++) {
+        setFrontendBackend(backends[b]);
+        uint32_t cycles = measureFrameCycles(workspace);
+        
+        // measureFrameCycles оставляет результат тестового кадра в workspace
+        float max_rel_error = 0;
+        for (int i = 0; i < NUM_MELS; i++) {
+            float denom = fabsf(reference[i]) > 1e-6f ? fabsf(reference[i]) : 1e-6f;
+            float err = fabsf(workspace->mel_energies[i] - reference[i]) / denom;
+            max_rel_error = err > max_rel_error ? err : max_rel_error;
+        }
+        
+        Serial.print(backends[b]->name);
+        Serial.print(": тактов на кадр "); Serial.print(cycles);
+        Serial.print(", макс. отн. ошибка к эталону "); Serial.println(max_rel_error, 7);
+        
+        float log_error = 0;
+        uint32_t log_cycles = measureLogCycles(backends[b], reference, &log_error);
+        Serial.print("  log2 кадра: тактов "); Serial.print(log_cycles);
+        Serial.print(" (log2f: "); Serial.print(libm_log_cycles);
+        Serial.print("), макс. ошибка "); Serial.println(log_error, 7);
+        
+        // Магнитуды тестового кадра остались в workspace->fft_buffer
+        Serial.print("  вычитание шума: +"); Serial.print(measureNoiseCycles(backends[b], workspace->fft_buffer));
+        Serial.println(" тактов на кадр");
+    }
+    
+    setFrontendBackend(selected != nullptr ? selected : &kScalarFrontendBackend);
+#endif
+}
+
+void reportFrontendParallel(const int16_t* audio, int audio_size, float* spectrogram,
+                            FrontendWorkspace* workspace) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== ПАРАЛЛЕЛЬНЫЙ ФРОНТЕНД ===");
+    if (!frontendParallelEnabled()) {
+        Serial.println("Рабочая задача не запущена, окно считается на одном ядре");
+        return;
+    }
+    
+    FloatStats serial_stats;
+    FloatStats parallel_stats;
+    uint32_t serial_cycles = 0;
+    uint32_t parallel_cycles = 0;
+    for (int run = 0; run < FRONTEND_CHECK_WINDOW_RUNS; run++) {
+        uint32_t start = ESP.getCycleCount();
+        audioToMelSpectrogram(audio, audio_size, 0, spectrogram, workspace, &serial_stats);
+        serial_cycles += ESP.getCycleCount() - start;
+        
+        start = ESP.getCycleCount();
+        audioToMelSpectrogramParallel(audio, audio_size, 0, spectrogram, workspace, &parallel_stats);
+        parallel_cycles += ESP.getCycleCount() - start;
+    }
+    
+    // Такты вызывающего ядра = время от fork до join
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    uint32_t serial_us = serial_cycles / FRONTEND_CHECK_WINDOW_RUNS / mhz;
+    uint32_t parallel_us = parallel_cycles / FRONTEND_CHECK_WINDOW_RUNS / mhz;
+    Serial.print("Окно на одном ядре: "); Serial.print(serial_us); Serial.println(" мкс");
+    Serial.print("Окно на двух ядрах: "); Serial.print(parallel_us); Serial.println(" мкс");
+    if (parallel_us > 0) {
+        Serial.print("Ускорение: x"); Serial.println((float)serial_us / parallel_us, 2);
+    }
+    
+    bool match = serial_stats.max == parallel_stats.max && serial_stats.sum == parallel_stats.sum &&
+                 serial_stats.count_above == parallel_stats.count_above;
+    Serial.print("Совпадение с однопоточным: "); Serial.println(match ? "ДА" : "НЕТ");
+    Serial.print("Стек рабочей задачи: использовано максимум "); Serial.print(frontendWorkerStackUsed());
+    Serial.print(" из "); Serial.println(FRONTEND_WORKER_STACK_SIZE);
+#endif
+}
@@ -0,0 +1,18 @@
+#ifndef FRONTEND_CHECK_H
+#define FRONTEND_CHECK_H
+
+#include "audio_processing.h"
+
+// Замер тактов на кадр для каждого доступного бэкенда фронтенда и сверка
+// его мель-энергий со скалярным эталоном на одном и том же тестовом кадре,
+// затем такты и ошибка быстрого log2 мель-энергий кадра против log2f
+// и такты, добавляемые вычитанием шума в мель-области.
+// После проверки восстанавливается бэкенд, выбранный initFrontend()
+void reportFrontendBackends(FrontendWorkspace* workspace);
+
+// Время полного пересчета окна на одном ядре и на двух (frontend_parallel.h),
+// сверка результатов и запас стека рабочей задачи
+void reportFrontendParallel(const int16_t* audio, int audio_size, float* spectrogram,
+                            FrontendWorkspace* workspace);
+
+#endif // FRONTEND_CHECK_H
@@ -0,0 +1,82 @@
+#include "frontend_kernels.h"
+#include "frontend_kernels_scalar.h"
+#include "constexpr_math.h"
+#include <string.h>
+
+// Узлы быстрого log2 - середины интервалов мантиссы, строятся компилятором
+static constexpr FastLog2Table makeFastLog2Table() {
+    FastLog2Table table = {};
+    for (int i = 0; i < FAST_LOG2_TABLE_SIZE; i++) {
+        double center = 1.0 + (i + 0.5) / FAST_LOG2_TABLE_SIZE;
+        table.log2_center[i] = (float)(constexprLog(center) / CONSTEXPR_LN2);
+        table.inv_center[i] = (float)(1.0 / center);
+    }
+    return table;
+}
+
+constexpr FastLog2Table kFastLog2Table = makeFastLog2Table();
+
+// Скалярный бэкенд - переносимая эталонная реализация (frontend_kernels_scalar.h)
+
+const FrontendBackend kScalarFrontendBackend = {
+    "scalar",
+    nullptr,
+    windowScalar,
+    fftScalar,
+    magnitudeScalar,
+    melMacScalar,
+    log2Scalar,
+};
+
+// Выбор бэкенда по возможностям процессора
+
+static bool backendSupported(const FrontendBackend* backend) {
+#ifdef FRONTEND_HAS_AVX2
+    if (backend == &kAvx2FrontendBackend) {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+    return backend != nullptr;
+}
+
+static const FrontendBackend* const kBackendsByPriority[] = {
+#ifdef FRONTEND_HAS_AVX2
+    &kAvx2FrontendBackend,
+#endif
+#ifdef FRONTEND_HAS_NEON
+    &kNeonFrontendBackend,
+#endif
+#ifdef FRONTEND_HAS_ESP_DSP
+    &kEspDspFrontendBackend,
+#endif
+    &kScalarFrontendBackend,
+};
+
+const FrontendBackend* selectFrontendBackend() {
+    for (const FrontendBackend* backend : kBackendsByPriority) {
+        if (backendSupported(backend)) {
+            return backend;
+        }
+    }
+    return &kScalarFrontendBackend;
+}
+
+int availableFrontendBackends(const FrontendBackend** backends, int max_count) {
+    int count = 0;
+    for (const FrontendBackend* backend : kBackendsByPriority) {
+        if (count < max_count && backendSupported(backend)) {
+            backends[count++] = backend;
+        }
+    }
+    return count;
+}
+
+const FrontendBackend* findFrontendBackend(const char* name) {
+    for (const FrontendBackend* backend : kBackendsByPriority) {
+        if (strcmp(backend->name, name) == 0 && backendSupported(backend)) {
+            return backend;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,162 @@
+#ifndef FRONTEND_KERNELS_H
+#define FRONTEND_KERNELS_H
+
+#include <stdint.h>
+
+// Вычислительные ядра фронтенда: окно, бабочки FFT, магнитуды, MAC мель-фильтров
+// и быстрый log2 (логарифмическая шкала спектрограммы).
+// Бэкенд выбирается во время выполнения по возможностям процессора
+// (selectFrontendBackend). Хостовые бэкенды (scalar, avx2, neon) выполняют одни
+// и те же операции в одном и том же порядке и дают побитово одинаковый результат
+// (сборка должна идти с -ffp-contract=off, чтобы компилятор не сливал умножение
+// и сложение в FMA только в одном из вариантов). Бэкенд esp-dsp использует
+// собственные таблицы и порядок суммирования и совпадает со скалярным
+// с точностью до ошибки округления.
+
+// Разреженная мель-банка: для фильтра i веса weights[offset[i] .. + length[i])
+// применяются к бинам start[i] .. start[i] + length[i]
+struct MelFilterbank {
+    const int16_t* start;
+    const int16_t* length;
+    const int16_t* offset;
+    const float* weights;
+    int num_mels;
+};
+
+// Число частичных сумм MAC мель-фильтра. Скалярное ядро накапливает бин j
+// в сумму j % MEL_MAC_LANES и складывает суммы по порядку в конце - так же,
+// как векторные ядра, поэтому результаты совпадают побитово
+const int MEL_MAC_LANES = 8;
+
+// Вычитание шума в мель-области (spectral subtraction). Выполняется ядром
+// melMac над готовой суммой полосы, без отдельного прохода по кадру:
+//   noise += (e < noise ? fall : rise) * (e - noise)    (только при update)
+//   e' = max(e - oversubtraction * noise, floor * e)
+// Оценка быстро опускается к паузам и медленно поднимается, поэтому следует
+// за стационарным фоном (вентилятор, вентиляция), а не за событиями
+struct MelNoiseSuppressor {
+    float* noise;              // [num_mels]; < 0 - полоса еще не оценена
+    float rise;
+    float fall;
+    float oversubtraction;
+    float floor;               // доля энергии, остающаяся всегда
+    bool update;               // false - только вычитание (кадры окна на двух ядрах)
+};
+
+static inline float suppressMelNoise(const MelNoiseSuppressor* suppressor, int band, float energy) {
+    float noise = suppressor->noise[band];
+    if (suppressor->update) {
+        noise = noise < 0 ? energy
+                          : noise + (energy < noise ? suppressor->fall : suppressor->rise) * (energy - noise);
+        suppressor->noise[band] = noise;
+    }
+    if (noise < 0) {
+        return energy;
+    }
+    float clean = energy - suppressor->oversubtraction * noise;
+    float floor = suppressor->floor * energy;
+    return clean > floor ? clean : floor;
+}
+
+struct FrontendBackend {
+    const char* name;
+    
+    // Подготовка внутренних таблиц бэкенда (может отсутствовать)
+    bool (*init)(int fft_size);
+    
+    // fft_data[2i] = frame[i] * window[i], fft_data[2i + 1] = 0
+    void (*window)(const float* frame, const float* window, float* fft_data, int size);
+    
+    // FFT на месте над чередующимися (re, im) отсчетами: перестановка
+    // по bit_reverse, затем бабочки DIT. twiddles - поворачивающие множители
+    // по стадиям: для стадии с полушириной h множители j = 0..h-1 лежат
+    // с комплексного индекса h - 1
+    void (*fft)(float* fft_data, const float* twiddles, const uint16_t* bit_reverse, int size);
+    
+    // magnitudes[i] = |fft_data[i]| для i < bins
+    void (*magnitude)(const float* fft_data, float* magnitudes, int bins);
+    
+    // mel_energies[i] = сумма magnitudes[start + j] * weights[offset + j],
+    // затем вычитание шума suppressor (nullptr - без вычитания)
+    void (*melMac)(const float* magnitudes, const MelFilterbank* filterbank, float* mel_energies,
+                   const MelNoiseSuppressor* suppressor);
+    
+    // data[i] = log2(data[i]) на месте (быстрое приближение, см. FastLog2Table)
+    void (*log2)(float* data, int size);
+};
+
+// Быстрый log2 для x >= 0: x = 2^e * m, m в [1, 2). Старшие
+// FAST_LOG2_TABLE_BITS бит мантиссы выбирают узел c (середина интервала),
+// остаток t = m / c - 1 (|t| < 2^-8) идет в полином
+//   log2(m) = log2(c) + t * (A1 + A2 * t)
+// Ошибка для m в [1, 2) - до 2.2e-7. Вне [1, 2) к ней добавляется округление
+// результата до float (половина шага float у |log2 x|): на 2^-40..2^20 максимум
+// 2.1e-6 против 1.9e-6 у log2f (test/test_fast_log2).
+// Для x = 0 и денормалов результат около -127
+const int FAST_LOG2_TABLE_BITS = 7;
+const int FAST_LOG2_TABLE_SIZE = 1 << FAST_LOG2_TABLE_BITS;
+const float FAST_LOG2_A1 = 1.44269504f;   // 1 / ln2
+const float FAST_LOG2_A2 = -0.72134752f;  // -1 / (2 ln2)
+
+struct FastLog2Table {
+    float log2_center[FAST_LOG2_TABLE_SIZE];
+    float inv_center[FAST_LOG2_TABLE_SIZE];
+};
+
+extern const FastLog2Table kFastLog2Table;
+
+// Векторные бэкенды собираются только на хосте соответствующей архитектуры
+#if defined(__x86_64__) || defined(__i386__)
+#define FRONTEND_HAS_AVX2 1
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define FRONTEND_HAS_NEON 1
+#endif
+// Оптимизированные FFT и скалярное произведение esp-dsp (PIE на ESP32-S3).
+// Отключается флагом -DFRONTEND_NO_ESP_DSP. На хосте собирается с флагом
+// -DFRONTEND_ESP_DSP_REFERENCE поверх эталонных ANSI-версий функций esp-dsp
+// (test/esp_dsp_reference) - для проверки совпадения со скалярным бэкендом
+#if (defined(ESP_PLATFORM) || defined(FRONTEND_ESP_DSP_REFERENCE)) && !defined(FRONTEND_NO_ESP_DSP) && \
+    defined(__has_include)
+#if __has_include("esp_dsp.h")
+#define FRONTEND_HAS_ESP_DSP 1
+#endif
+#endif
+
+extern const FrontendBackend kScalarFrontendBackend;
+#ifdef FRONTEND_HAS_AVX2
+extern const FrontendBackend kAvx2FrontendBackend;
+#endif
+#ifdef FRONTEND_HAS_NEON
+extern const FrontendBackend kNeonFrontendBackend;
+#endif
+#ifdef FRONTEND_HAS_ESP_DSP
+extern const FrontendBackend kEspDspFrontendBackend;
+#endif
+
+// Перестановка комплексных отсчетов в порядок бит-реверса (общая для бэкендов)
+static inline void bitReversePermute(float* fft_data, const uint16_t* bit_reverse, int size) {
+    for (int i = 0; i < size; i++) {
+        int j = bit_reverse[i];
+        if (i < j) {
+            float re = fft_data[2 * i];
+            float im = fft_data[2 * i + 1];
+            fft_data[2 * i] = fft_data[2 * j];
+            fft_data[2 * i + 1] = fft_data[2 * j + 1];
+            fft_data[2 * j] = re;
+            fft_data[2 * j + 1] = im;
+        }
+    }
+}
+
+// Лучший бэкенд для текущего процессора (скалярный, если векторных нет)
+const FrontendBackend* selectFrontendBackend();
+
+// Поиск бэкенда по имени (для сравнения бэкендов);
+// nullptr, если такого бэкенда нет в сборке или процессор его не поддерживает
+const FrontendBackend* findFrontendBackend(const char* name);
+
+// Все бэкенды, доступные в сборке и на текущем процессоре. Возвращает их число
+int availableFrontendBackends(const FrontendBackend** backends, int max_count);
+
+#endif // FRONTEND_KERNELS_H
@@ -0,0 +1,165 @@
+#include "frontend_kernels.h"
+#include "frontend_kernels_scalar.h"
+
+// AVX2-ядра для хостовой сборки (шлюз обработки записей).
+// Компилируются с target("avx2") и вызываются только после проверки
+// __builtin_cpu_supports("avx2"). FMA намеренно не используется:
+// результат должен совпадать со скалярным побитово.
+
+#ifdef FRONTEND_HAS_AVX2
+
+#include <immintrin.h>
+#include <math.h>
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET
+static void windowAvx2(const float* frame, const float* window, float* fft_data, int size) {
+    const __m256 zero = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(frame + i), _mm256_loadu_ps(window + i));
+        // Чередование с нулями: (v0, 0, v1, 0, ...) внутри 128-битных половин
+        __m256 lo = _mm256_unpacklo_ps(v, zero);
+        __m256 hi = _mm256_unpackhi_ps(v, zero);
+        _mm256_storeu_ps(fft_data + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(fft_data + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < size; i++) {
+        fft_data[2 * i] = frame[i] * window[i];
+        fft_data[2 * i + 1] = 0;
+    }
+}
+
+// Комплексное умножение четырех пар (w * b) в чередующемся формате:
+// re = w_re * b_re - w_im * b_im, im = w_re * b_im + w_im * b_re
+AVX2_TARGET
+static inline __m256 complexMulAvx2(__m256 w, __m256 b) {
+    __m256 w_real = _mm256_moveldup_ps(w);
+    __m256 w_imag = _mm256_movehdup_ps(w);
+    __m256 b_swap = _mm256_permute_ps(b, 0xB1);
+    return _mm256_addsub_ps(_mm256_mul_ps(w_real, b), _mm256_mul_ps(w_imag, b_swap));
+}
+
+AVX2_TARGET
+static void fftAvx2(float* fft_data, const float* twiddles, const uint16_t* bit_reverse, int size) {
+    bitReversePermute(fft_data, bit_reverse, size);
+    
+    for (int half = 1; half < size; half <<= 1) {
+        const float* w = twiddles + 2 * (half - 1);
+        
+        for (int k = 0; k < size; k += 2 * half) {
+            float* a = fft_data + 2 * k;
+            float* b = fft_data + 2 * (k + half);
+            
+            int j = 0;
+            for (; j + 4 <= half; j += 4) {
+                __m256 t = complexMulAvx2(_mm256_loadu_ps(w + 2 * j), _mm256_loadu_ps(b + 2 * j));
+                __m256 va = _mm256_loadu_ps(a + 2 * j);
+                _mm256_storeu_ps(b + 2 * j, _mm256_sub_ps(va, t));
+                _mm256_storeu_ps(a + 2 * j, _mm256_add_ps(va, t));
+            }
+            // Первые две стадии (half = 1, 2) уже векторов
+            for (; j < half; j++) {
+                float w_real = w[2 * j];
+                float w_imag = w[2 * j + 1];
+                float b_real = b[2 * j];
+                float b_imag = b[2 * j + 1];
+                
+                float t_real = w_real * b_real - w_imag * b_imag;
+                float t_imag = w_real * b_imag + w_imag * b_real;
+                
+                b[2 * j] = a[2 * j] - t_real;
+                b[2 * j + 1] = a[2 * j + 1] - t_imag;
+                a[2 * j] += t_real;
+                a[2 * j + 1] += t_imag;
+            }
+        }
+    }
+}
+
+AVX2_TARGET
+static void magnitudeAvx2(const float* fft_data, float* magnitudes, int bins) {
+    int i = 0;
+    for (; i + 8 <= bins; i += 8) {
+        __m256 c0 = _mm256_loadu_ps(fft_data + 2 * i);
+        __m256 c1 = _mm256_loadu_ps(fft_data + 2 * i + 8);
+        // hadd складывает re^2 + im^2 в том же порядке, что и скалярный код,
+        // но перемешивает 64-битные четверти - возвращаем порядок перестановкой
+        __m256 sum = _mm256_hadd_ps(_mm256_mul_ps(c0, c0), _mm256_mul_ps(c1, c1));
+        sum = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), 0xD8));
+        _mm256_storeu_ps(magnitudes + i, _mm256_sqrt_ps(sum));
+    }
+    for (; i < bins; i++) {
+        float re = fft_data[2 * i];
+        float im = fft_data[2 * i + 1];
+        magnitudes[i] = sqrtf(re * re + im * im);
+    }
+}
+
+AVX2_TARGET
+static void melMacAvx2(const float* magnitudes, const MelFilterbank* filterbank, float* mel_energies,
+                       const MelNoiseSuppressor* suppressor) {
+    static_assert(MEL_MAC_LANES == 8, "одна частичная сумма на линию AVX");
+    
+    for (int i = 0; i < filterbank->num_mels; i++) {
+        const float* m = magnitudes + filterbank->start[i];
+        const float* w = filterbank->weights + filterbank->offset[i];
+        int length = filterbank->length[i];
+        
+        __m256 vacc = _mm256_setzero_ps();
+        int j = 0;
+        for (; j + 8 <= length; j += 8) {
+            vacc = _mm256_add_ps(vacc, _mm256_mul_ps(_mm256_loadu_ps(m + j), _mm256_loadu_ps(w + j)));
+        }
+        
+        float acc[MEL_MAC_LANES];
+        _mm256_storeu_ps(acc, vacc);
+        for (; j < length; j++) {
+            acc[j % MEL_MAC_LANES] += m[j] * w[j];
+        }
+        
+        float sum = 0;
+        for (int lane = 0; lane < MEL_MAC_LANES; lane++) {
+            sum += acc[lane];
+        }
+        mel_energies[i] = suppressor != nullptr ? suppressMelNoise(suppressor, i, sum) : sum;
+    }
+}
+
+// Узлы таблицы выбираются сбором (gather) по 8 индексам
+AVX2_TARGET
+static void log2Avx2(float* data, int size) {
+    const __m256i mantissa_mask = _mm256_set1_epi32(0x007FFFFF);
+    const __m256i one_bits = _mm256_set1_epi32(0x3F800000);
+    const __m256i index_mask = _mm256_set1_epi32(FAST_LOG2_TABLE_SIZE - 1);
+    const __m256i bias = _mm256_set1_epi32(127);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 a1 = _mm256_set1_ps(FAST_LOG2_A1);
+    const __m256 a2 = _mm256_set1_ps(FAST_LOG2_A2);
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(data + i));
+        __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), bias));
+        __m256i index = _mm256_and_si256(_mm256_srli_epi32(bits, 23 - FAST_LOG2_TABLE_BITS), index_mask);
+        __m256 mantissa = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, mantissa_mask), one_bits));
+        __m256 inv_center = _mm256_i32gather_ps(kFastLog2Table.inv_center, index, 4);
+        __m256 log2_center = _mm256_i32gather_ps(kFastLog2Table.log2_center, index, 4);
+        __m256 t = _mm256_sub_ps(_mm256_mul_ps(mantissa, inv_center), one);
+        __m256 poly = _mm256_add_ps(log2_center, _mm256_mul_ps(t, _mm256_add_ps(a1, _mm256_mul_ps(a2, t))));
+        _mm256_storeu_ps(data + i, _mm256_add_ps(exponent, poly));
+    }
+    log2Scalar(data + i, size - i);
+}
+
+const FrontendBackend kAvx2FrontendBackend = {
+    "avx2",
+    nullptr,
+    windowAvx2,
+    fftAvx2,
+    magnitudeAvx2,
+    melMacAvx2,
+    log2Avx2,
+};
+
+#endif // FRONTEND_HAS_AVX2
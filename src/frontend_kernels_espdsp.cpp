@@ -0,0 +1,71 @@
+#include "frontend_kernels.h"
+#include "frontend_kernels_scalar.h"
+
+// Бэкенд esp-dsp для ESP32-S3: FFT radix-2, поэлементное умножение и скалярное
+// произведение из библиотеки esp-dsp (ассемблерные версии с инструкциями PIE).
+// Подключается автоматически, если заголовок esp_dsp.h есть в сборке.
+
+#ifdef FRONTEND_HAS_ESP_DSP
+
+#include "esp_dsp.h"
+#include <math.h>
+
+// Поворачивающие множители esp-dsp (FFT_SIZE комплексных -> FFT_SIZE float).
+// Размер с запасом под максимальный поддерживаемый кадр
+static const int ESP_DSP_MAX_FFT_SIZE = 1024;
+static float espdsp_twiddles[ESP_DSP_MAX_FFT_SIZE];
+
+static bool initEspDsp(int fft_size) {
+    if (fft_size > ESP_DSP_MAX_FFT_SIZE) {
+        return false;
+    }
+    return dsps_fft2r_init_fc32(espdsp_twiddles, fft_size) == ESP_OK;
+}
+
+static void windowEspDsp(const float* frame, const float* window, float* fft_data, int size) {
+    // Реальная часть пишется с шагом 2 прямо в комплексный буфер
+    dsps_mul_f32(frame, window, fft_data, size, 1, 1, 2);
+    for (int i = 0; i < size; i++) {
+        fft_data[2 * i + 1] = 0;
+    }
+}
+
+static void fftEspDsp(float* fft_data, const float* /*twiddles*/, const uint16_t* /*bit_reverse*/, int size) {
+    // esp-dsp принимает естественный порядок и выдает бит-реверсный,
+    // собственные таблицы использует вместо twiddles/bit_reverse
+    dsps_fft2r_fc32(fft_data, size);
+    dsps_bit_rev_fc32(fft_data, size);
+}
+
+static void magnitudeEspDsp(const float* fft_data, float* magnitudes, int bins) {
+    for (int i = 0; i < bins; i++) {
+        float re = fft_data[2 * i];
+        float im = fft_data[2 * i + 1];
+        magnitudes[i] = sqrtf(re * re + im * im);
+    }
+}
+
+static void melMacEspDsp(const float* magnitudes, const MelFilterbank* filterbank, float* mel_energies,
+                         const MelNoiseSuppressor* suppressor) {
+    for (int i = 0; i < filterbank->num_mels; i++) {
+        float sum = 0;
+        int length = filterbank->length[i];
+        if (length > 0) {
+            dsps_dotprod_f32(magnitudes + filterbank->start[i],
+                             filterbank->weights + filterbank->offset[i], &sum, length);
+        }
+        mel_energies[i] = suppressor != nullptr ? suppressMelNoise(suppressor, i, sum) : sum;
+    }
+}
+
+const FrontendBackend kEspDspFrontendBackend = {
+    "esp-dsp",
+    initEspDsp,
+    windowEspDsp,
+    fftEspDsp,
+    magnitudeEspDsp,
+    melMacEspDsp,
+    log2Scalar,  // в esp-dsp нет логарифма; скалярное ядро без libm
+};
+
+#endif // FRONTEND_HAS_ESP_DSP
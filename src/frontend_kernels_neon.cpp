@@ -0,0 +1,161 @@
+#include "frontend_kernels.h"
+#include "frontend_kernels_scalar.h"
+
+// NEON-ядра для хостовой сборки на ARM (aarch64 шлюзы). NEON обязателен
+// для AArch64, поэтому отдельной проверки во время выполнения не требуется.
+// Умножение и сложение не сливаются (vmul + vadd, а не vfma), чтобы
+// результат совпадал со скалярным побитово.
+
+#ifdef FRONTEND_HAS_NEON
+
+#include <arm_neon.h>
+#include <math.h>
+
+static void windowNeon(const float* frame, const float* window, float* fft_data, int size) {
+    const float32x4_t zero = vdupq_n_f32(0);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        float32x4x2_t out;
+        out.val[0] = vmulq_f32(vld1q_f32(frame + i), vld1q_f32(window + i));
+        out.val[1] = zero;
+        vst2q_f32(fft_data + 2 * i, out);
+    }
+    for (; i < size; i++) {
+        fft_data[2 * i] = frame[i] * window[i];
+        fft_data[2 * i + 1] = 0;
+    }
+}
+
+static void fftNeon(float* fft_data, const float* twiddles, const uint16_t* bit_reverse, int size) {
+    bitReversePermute(fft_data, bit_reverse, size);
+    
+    for (int half = 1; half < size; half <<= 1) {
+        const float* w = twiddles + 2 * (half - 1);
+        
+        for (int k = 0; k < size; k += 2 * half) {
+            float* a = fft_data + 2 * k;
+            float* b = fft_data + 2 * (k + half);
+            
+            int j = 0;
+            for (; j + 4 <= half; j += 4) {
+                // vld2 раскладывает (re, im) по отдельным регистрам
+                float32x4x2_t vw = vld2q_f32(w + 2 * j);
+                float32x4x2_t vb = vld2q_f32(b + 2 * j);
+                float32x4x2_t va = vld2q_f32(a + 2 * j);
+                
+                float32x4_t t_real = vsubq_f32(vmulq_f32(vw.val[0], vb.val[0]), vmulq_f32(vw.val[1], vb.val[1]));
+                float32x4_t t_imag = vaddq_f32(vmulq_f32(vw.val[0], vb.val[1]), vmulq_f32(vw.val[1], vb.val[0]));
+                
+                float32x4x2_t out_b, out_a;
+                out_b.val[0] = vsubq_f32(va.val[0], t_real);
+                out_b.val[1] = vsubq_f32(va.val[1], t_imag);
+                out_a.val[0] = vaddq_f32(va.val[0], t_real);
+                out_a.val[1] = vaddq_f32(va.val[1], t_imag);
+                vst2q_f32(b + 2 * j, out_b);
+                vst2q_f32(a + 2 * j, out_a);
+            }
+            // Первые две стадии (half = 1, 2) уже векторов
+            for (; j < half; j++) {
+                float w_real = w[2 * j];
+                float w_imag = w[2 * j + 1];
+                float b_real = b[2 * j];
+                float b_imag = b[2 * j + 1];
+                
+                float t_real = w_real * b_real - w_imag * b_imag;
+                float t_imag = w_real * b_imag + w_imag * b_real;
+                
+                b[2 * j] = a[2 * j] - t_real;
+                b[2 * j + 1] = a[2 * j + 1] - t_imag;
+                a[2 * j] += t_real;
+                a[2 * j + 1] += t_imag;
+            }
+        }
+    }
+}
+
+static void magnitudeNeon(const float* fft_data, float* magnitudes, int bins) {
+    int i = 0;
+    for (; i + 4 <= bins; i += 4) {
+        float32x4x2_t c = vld2q_f32(fft_data + 2 * i);
+        float32x4_t sum = vaddq_f32(vmulq_f32(c.val[0], c.val[0]), vmulq_f32(c.val[1], c.val[1]));
+        vst1q_f32(magnitudes + i, vsqrtq_f32(sum));
+    }
+    for (; i < bins; i++) {
+        float re = fft_data[2 * i];
+        float im = fft_data[2 * i + 1];
+        magnitudes[i] = sqrtf(re * re + im * im);
+    }
+}
+
+static void melMacNeon(const float* magnitudes, const MelFilterbank* filterbank, float* mel_energies,
+                       const MelNoiseSuppressor* suppressor) {
+    static_assert(MEL_MAC_LANES == 8, "две 4-линейные суммы на 8 частичных");
+    
+    for (int i = 0; i < filterbank->num_mels; i++) {
+        const float* m = magnitudes + filterbank->start[i];
+        const float* w = filterbank->weights + filterbank->offset[i];
+        int length = filterbank->length[i];
+        
+        float32x4_t acc_lo = vdupq_n_f32(0);
+        float32x4_t acc_hi = vdupq_n_f32(0);
+        int j = 0;
+        for (; j + 8 <= length; j += 8) {
+            acc_lo = vaddq_f32(acc_lo, vmulq_f32(vld1q_f32(m + j), vld1q_f32(w + j)));
+            acc_hi = vaddq_f32(acc_hi, vmulq_f32(vld1q_f32(m + j + 4), vld1q_f32(w + j + 4)));
+        }
+        
+        float acc[MEL_MAC_LANES];
+        vst1q_f32(acc, acc_lo);
+        vst1q_f32(acc + 4, acc_hi);
+        for (; j < length; j++) {
+            acc[j % MEL_MAC_LANES] += m[j] * w[j];
+        }
+        
+        float sum = 0;
+        for (int lane = 0; lane < MEL_MAC_LANES; lane++) {
+            sum += acc[lane];
+        }
+        mel_energies[i] = suppressor != nullptr ? suppressMelNoise(suppressor, i, sum) : sum;
+    }
+}
+
+// Сбора в NEON нет: узлы таблицы загружаются по линиям
+static void log2Neon(float* data, int size) {
+    const uint32x4_t mantissa_mask = vdupq_n_u32(0x007FFFFF);
+    const uint32x4_t one_bits = vdupq_n_u32(0x3F800000);
+    const int32x4_t bias = vdupq_n_s32(127);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t a1 = vdupq_n_f32(FAST_LOG2_A1);
+    const float32x4_t a2 = vdupq_n_f32(FAST_LOG2_A2);
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(data + i));
+        float32x4_t exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), bias));
+        uint32x4_t index = vandq_u32(vshrq_n_u32(bits, 23 - FAST_LOG2_TABLE_BITS), vdupq_n_u32(FAST_LOG2_TABLE_SIZE - 1));
+        float32x4_t mantissa = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, mantissa_mask), one_bits));
+        uint32_t lanes[4];
+        vst1q_u32(lanes, index);
+        float inv[4];
+        float center[4];
+        for (int lane = 0; lane < 4; lane++) {
+            inv[lane] = kFastLog2Table.inv_center[lanes[lane]];
+            center[lane] = kFastLog2Table.log2_center[lanes[lane]];
+        }
+        float32x4_t t = vsubq_f32(vmulq_f32(mantissa, vld1q_f32(inv)), one);
+        float32x4_t poly = vaddq_f32(vld1q_f32(center), vmulq_f32(t, vaddq_f32(a1, vmulq_f32(a2, t))));
+        vst1q_f32(data + i, vaddq_f32(exponent, poly));
+    }
+    log2Scalar(data + i, size - i);
+}
+
+const FrontendBackend kNeonFrontendBackend = {
+    "neon",
+    nullptr,
+    windowNeon,
+    fftNeon,
+    magnitudeNeon,
+    melMacNeon,
+    log2Neon,
+};
+
+#endif // FRONTEND_HAS_NEON
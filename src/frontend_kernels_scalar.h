@@ -0,0 +1,90 @@
+#ifndef FRONTEND_KERNELS_SCALAR_H
+#define FRONTEND_KERNELS_SCALAR_H
+
+#include "frontend_kernels.h"
+#include <math.h>
+#include <string.h>
+
+// Скалярные ядра - переносимая эталонная реализация. Определены в заголовке,
+// чтобы MelFrontend<Config> мог встраивать их с размерами, известными при
+// компиляции (развертка циклов и автовекторизация без косвенного вызова)
+
+inline void windowScalar(const float* frame, const float* window, float* fft_data, int size) {
+    for (int i = 0; i < size; i++) {
+        fft_data[2 * i] = frame[i] * window[i];
+        fft_data[2 * i + 1] = 0;
+    }
+}
+
+inline void fftScalar(float* fft_data, const float* twiddles, const uint16_t* bit_reverse, int size) {
+    bitReversePermute(fft_data, bit_reverse, size);
+    
+    for (int half = 1; half < size; half <<= 1) {
+        const float* w = twiddles + 2 * (half - 1);
+        
+        for (int k = 0; k < size; k += 2 * half) {
+            float* a = fft_data + 2 * k;
+            float* b = fft_data + 2 * (k + half);
+            
+            for (int j = 0; j < half; j++) {
+                float w_real = w[2 * j];
+                float w_imag = w[2 * j + 1];
+                float b_real = b[2 * j];
+                float b_imag = b[2 * j + 1];
+                
+                float t_real = w_real * b_real - w_imag * b_imag;
+                float t_imag = w_real * b_imag + w_imag * b_real;
+                
+                b[2 * j] = a[2 * j] - t_real;
+                b[2 * j + 1] = a[2 * j + 1] - t_imag;
+                a[2 * j] += t_real;
+                a[2 * j + 1] += t_imag;
+            }
+        }
+    }
+}
+
+inline void magnitudeScalar(const float* fft_data, float* magnitudes, int bins) {
+    for (int i = 0; i < bins; i++) {
+        float re = fft_data[2 * i];
+        float im = fft_data[2 * i + 1];
+        magnitudes[i] = sqrtf(re * re + im * im);
+    }
+}
+
+inline void melMacScalar(const float* magnitudes, const MelFilterbank* filterbank, float* mel_energies,
+                         const MelNoiseSuppressor* suppressor) {
+    for (int i = 0; i < filterbank->num_mels; i++) {
+        const float* m = magnitudes + filterbank->start[i];
+        const float* w = filterbank->weights + filterbank->offset[i];
+        int length = filterbank->length[i];
+        
+        float acc[MEL_MAC_LANES] = {0};
+        for (int j = 0; j < length; j++) {
+            acc[j % MEL_MAC_LANES] += m[j] * w[j];
+        }
+        
+        float sum = 0;
+        for (int lane = 0; lane < MEL_MAC_LANES; lane++) {
+            sum += acc[lane];
+        }
+        mel_energies[i] = suppressor != nullptr ? suppressMelNoise(suppressor, i, sum) : sum;
+    }
+}
+
+inline void log2Scalar(float* data, int size) {
+    const FastLog2Table& table = kFastLog2Table;
+    for (int i = 0; i < size; i++) {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        int32_t exponent = (int32_t)(bits >> 23) - 127;
+        uint32_t index = (bits >> (23 - FAST_LOG2_TABLE_BITS)) & (FAST_LOG2_TABLE_SIZE - 1);
+        uint32_t mantissa_bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+        float mantissa;
+        memcpy(&mantissa, &mantissa_bits, sizeof(mantissa));
+        float t = mantissa * table.inv_center[index] - 1.0f;
+        data[i] = (float)exponent + (table.log2_center[index] + t * (FAST_LOG2_A1 + FAST_LOG2_A2 * t));
+    }
+}
+
+#endif // FRONTEND_KERNELS_SCALAR_H
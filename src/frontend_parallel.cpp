@@ -0,0 +1,83 @@
+#include "frontend_parallel.h"
+#include "alloc_tracker.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Задание рабочей задаче. Уведомления задач FreeRTOS проходят через
+// критическую секцию и служат барьером памяти между ядрами
+struct FrontendJob {
+    const int16_t* audio;
+    int audio_size;
+    int start;
+    float* spectrogram;
+    TaskHandle_t caller;
+    float max_val;
+};
+
+static FrontendJob job;
+static FrontendWorkspace* worker_workspace = nullptr;
+static TaskHandle_t worker_task = nullptr;
+
+static void frontendWorkerTask(void* arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stackBudgetBegin();
+        job.max_val = audioToMelFrames(job.audio, job.audio_size, job.start, job.spectrogram,
+                                       worker_workspace, FRONTEND_PARALLEL_SPLIT, NUM_FRAMES);
+        stackBudgetEnd();
+        xTaskNotifyGive(job.caller);
+    }
+}
+
+bool frontendParallelBegin(FrontendWorkspace* workspace) {
+    if (worker_task != nullptr) {
+        return true;
+    }
+
+    worker_workspace = workspace;
+    BaseType_t created = xTaskCreatePinnedToCore(frontendWorkerTask, "frontend", FRONTEND_WORKER_STACK_SIZE,
+                                                 nullptr, FRONTEND_WORKER_PRIORITY, &worker_task,
+                                                 FRONTEND_WORKER_CORE);
+    if (created != pdPASS) {
+        worker_task = nullptr;
+        return false;
+    }
+    stackBudgetRegisterTask(worker_task, FRONTEND_WORKER_STACK_SIZE, FRONTEND_WORKER_STACK_BUDGET);
+    return true;
+}
+
+bool frontendParallelEnabled() {
+    return worker_task != nullptr;
+}
+
+uint32_t frontendWorkerStackUsed() {
+    if (worker_task == nullptr) {
+        return 0;
+    }
+    // На ESP-IDF запас стека возвращается в байтах
+    return FRONTEND_WORKER_STACK_SIZE - uxTaskGetStackHighWaterMark(worker_task);
+}
+
+void audioToMelSpectrogramParallel(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                                   FrontendWorkspace* workspace, FloatStats* stats) {
+    if (worker_task == nullptr) {
+        audioToMelSpectrogram(audio, audio_size, start, spectrogram, workspace, stats);
+        return;
+    }
+
+    // Fork: вторая часть кадров уходит на ядро 0
+    job.audio = audio;
+    job.audio_size = audio_size;
+    job.start = start;
+    job.spectrogram = spectrogram;
+    job.caller = xTaskGetCurrentTaskHandle();
+    xTaskNotifyGive(worker_task);
+
+    float max_val = audioToMelFrames(audio, audio_size, start, spectrogram, workspace,
+                                     0, FRONTEND_PARALLEL_SPLIT);
+
+    // Join: нормализация - после того, как известны максимумы обеих частей
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    max_val = job.max_val > max_val ? job.max_val : max_val;
+    normalizeWindow(spectrogram, max_val, stats);
+}
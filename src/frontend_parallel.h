@@ -0,0 +1,36 @@
+#ifndef FRONTEND_PARALLEL_H
+#define FRONTEND_PARALLEL_H
+
+#include <Arduino.h>
+#include "audio_processing.h"
+
+// Параллельный режим фронтенда: кадры окна делятся между двумя ядрами.
+// Вызывающая задача (loop() на ядре 1) считает первые кадры, рабочая задача
+// на ядре 0 - остальные, со своей рабочей областью. Fork/join - уведомления
+// задач FreeRTOS, без очередей и выделения памяти на окно.
+// Нужен для полного пересчета окна (например, после пробуждения по VAD)
+
+const BaseType_t FRONTEND_WORKER_CORE = 0;
+const uint32_t FRONTEND_WORKER_STACK_SIZE = 3072;  // байт
+const uint32_t FRONTEND_WORKER_STACK_BUDGET = 2048; // байт на задание (alloc_tracker.h)
+const UBaseType_t FRONTEND_WORKER_PRIORITY = 2;    // выше loop(), чтобы сразу занять ядро 0
+
+// Кадры [0, FRONTEND_PARALLEL_SPLIT) считает вызывающая задача, остальные - рабочая.
+// Рабочая задача стартует позже на время пробуждения, поэтому ей кадр меньше
+const int FRONTEND_PARALLEL_SPLIT = (NUM_FRAMES + 1) / 2;
+
+// Запуск рабочей задачи с отдельной рабочей областью (см. memory_plan.h).
+// false - задачу создать не удалось, фронтенд остается однопоточным
+bool frontendParallelBegin(FrontendWorkspace* worker_workspace);
+bool frontendParallelEnabled();
+
+// Максимум использованного стека рабочей задачи, байт
+uint32_t frontendWorkerStackUsed();
+
+// То же, что audioToMelSpectrogram, но кадры считаются на двух ядрах.
+// Результат побитово совпадает с однопоточным. Без рабочей задачи -
+// обычный однопоточный расчет
+void audioToMelSpectrogramParallel(const int16_t* audio, int audio_size, int start, float* spectrogram,
+                                   FrontendWorkspace* workspace, FloatStats* stats = nullptr);
+
+#endif // FRONTEND_PARALLEL_H
@@ -0,0 +1,77 @@
+#include "goertzel_bank.h"
+#include <math.h>
+
+void goertzelBankBegin(GoertzelBank* bank, const float* freqs_hz, int count) {
+    bank->num_bins = count < GOERTZEL_MAX_BINS ? count : GOERTZEL_MAX_BINS;
+    for (int bin = 0; bin < bank->num_bins; bin++) {
+        bank->coeffs[bin] = 2.0f * cosf(2.0f * (float)M_PI * freqs_hz[bin] / SAMPLE_RATE);
+    }
+    bank->triggers = 0;
+    resetGoertzelBank(bank);
+}
+
+void resetGoertzelBank(GoertzelBank* bank) {
+    for (int bin = 0; bin < GOERTZEL_MAX_BINS; bin++) {
+        bank->power[bin] = 0;
+    }
+    bank->level = 0;
+    bank->background = 0;
+    bank->primed = false;
+    bank->above = false;
+    bank->hold_hops = 0;
+}
+
+bool goertzelBankUpdate(GoertzelBank* bank, const int16_t* hop, int size) {
+    // Рекурсии всех бинов в одном проходе по отсчетам
+    float s1[GOERTZEL_MAX_BINS] = {};
+    float s2[GOERTZEL_MAX_BINS] = {};
+    const int num_bins = bank->num_bins;
+    for (int i = 0; i < size; i++) {
+        float x = hop[i];
+        for (int bin = 0; bin < num_bins; bin++) {
+            float s = x + bank->coeffs[bin] * s1[bin] - s2[bin];
+            s2[bin] = s1[bin];
+            s1[bin] = s;
+        }
+    }
+
+    // |X|^2 * 4 / N^2 - квадрат амплитуды синуса на частоте бина
+    float norm = 4.0f / ((float)size * size);
+    float level = 0;
+    for (int bin = 0; bin < num_bins; bin++) {
+        float power = (s1[bin] * s1[bin] + s2[bin] * s2[bin] - bank->coeffs[bin] * s1[bin] * s2[bin]) * norm;
+        bank->power[bin] = power;
+        level += power;
+    }
+    level /= num_bins > 0 ? num_bins : 1;
+    bank->level = level;
+
+    if (bank->hold_hops > 0) {
+        bank->hold_hops--;
+    }
+
+    // Первый шаг после сброса только задает фон
+    if (!bank->primed) {
+        bank->primed = true;
+        bank->background = level;
+        return false;
+    }
+
+    float threshold = bank->background * GOERTZEL_THRESHOLD_RATIO;
+    bool above = level > threshold && level > GOERTZEL_MIN_POWER;
+    bool triggered = above && !bank->above;
+    bank->above = above;
+
+    // Пока уровень выше порога, активное состояние продлевается, а фон
+    // догоняет его медленно: короткое событие фон почти не сдвигает,
+    // устойчивая ступенька уходит под порог
+    if (above) {
+        bank->hold_hops = GOERTZEL_HOLD_HOPS;
+    }
+    float alpha = above ? GOERTZEL_BACKGROUND_ALPHA_ACTIVE : GOERTZEL_BACKGROUND_ALPHA;
+    bank->background += alpha * (level - bank->background);
+    if (triggered) {
+        bank->triggers++;
+    }
+    return triggered;
+}
@@ -0,0 +1,61 @@
+#ifndef GOERTZEL_BANK_H
+#define GOERTZEL_BANK_H
+
+#include <stdint.h>
+#include "audio_processing.h"
+
+// Предварительный отбор по нескольким частотам (сборка с -DGOERTZEL_TRIGGER).
+// Банк фильтров Герцеля считает мощность выбранных бинов по каждому шагу
+// захвата (блок HOP_LENGTH отсчетов, разрешение SAMPLE_RATE / HOP_LENGTH Гц)
+// прямо по отсчетам, без БПФ и мель-полос:
+//   s[n] = x[n] + c * s[n-1] - s[n-2],  c = 2 cos(2 pi f / fs)
+//   |X(f)|^2 = s1^2 + s2^2 - c * s1 * s2 в конце блока
+// На отсчет - одно умножение и два сложения на бин. Мощность бинов
+// приводится к квадрату амплитуды синуса. Срабатывание - средняя мощность
+// бинов выше фона * ratio и выше абсолютного минимума; после срабатывания
+// банк остается активным GOERTZEL_HOLD_HOPS шагов. Выше порога фон тоже
+// растет, но медленно: устойчивая ступенька фона в целевых бинах
+// (вентилятор, кондиционер) через ~1 с перестает держать банк активным.
+// Не зависит от Arduino - частоты и пороги настраиваются на записях на хосте
+
+const int GOERTZEL_MAX_BINS = 8;
+// Бой стекла: основная энергия удара и звона - 3-7 кГц, где речь и бытовой
+// шум слабее
+const float GOERTZEL_TARGET_HZ[] = {3000.0f, 4000.0f, 5000.0f, 6000.0f, 7000.0f};
+const int GOERTZEL_NUM_TARGETS = sizeof(GOERTZEL_TARGET_HZ) / sizeof(GOERTZEL_TARGET_HZ[0]);
+
+const float GOERTZEL_BACKGROUND_ALPHA = 0.02f;   // сглаживание фона (~50 шагов = 0.5 с)
+// Сглаживание фона выше порога: +20 дБ уходят под порог за ~120 шагов
+const float GOERTZEL_BACKGROUND_ALPHA_ACTIVE = 0.001f;
+const float GOERTZEL_THRESHOLD_RATIO = 8.0f;     // +9 дБ к фону
+const float GOERTZEL_MIN_POWER = 1.0e4f;         // амплитуда 100 (-50 дБ от полной шкалы)
+const int GOERTZEL_HOLD_HOPS = NUM_FRAMES;       // одно окно модели после срабатывания
+
+static_assert(GOERTZEL_NUM_TARGETS <= GOERTZEL_MAX_BINS, "Слишком много частот банка Герцеля");
+
+struct GoertzelBank {
+    int num_bins;
+    float coeffs[GOERTZEL_MAX_BINS];    // 2 cos(2 pi f / fs)
+    float power[GOERTZEL_MAX_BINS];     // мощность бинов последнего шага
+    float level;                        // средняя мощность бинов последнего шага
+    float background;                   // фон по шагам ниже порога
+    bool primed;
+    bool above;                         // предыдущий шаг был выше порога
+    int hold_hops;                      // осталось шагов активного состояния
+    uint32_t triggers;                  // срабатываний с запуска
+};
+
+// Частоты бинов (не больше GOERTZEL_MAX_BINS) и сброс состояния
+void goertzelBankBegin(GoertzelBank* bank, const float* freqs_hz, int count);
+
+void resetGoertzelBank(GoertzelBank* bank);
+
+// Обработка шага захвата. true - в этом шаге банк сработал
+bool goertzelBankUpdate(GoertzelBank* bank, const int16_t* hop, int size);
+
+// Банк сработал не раньше GOERTZEL_HOLD_HOPS шагов назад
+inline bool goertzelBankActive(const GoertzelBank& bank) {
+    return bank.hold_hops > 0;
+}
+
+#endif // GOERTZEL_BANK_H
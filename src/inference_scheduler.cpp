@@ -0,0 +1,58 @@
+#include "inference_scheduler.h"
+#include <math.h>
+
+void resetInferenceScheduler(InferenceScheduler* scheduler) {
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        scheduler->scene_log_mel[mel] = 0;
+        scheduler->reference_log_mel[mel] = 0;
+    }
+    scheduler->change = 0;
+    scheduler->primed = false;
+    scheduler->hops_since_inference = 0;
+    scheduler->candidates = 0;
+    scheduler->skipped = 0;
+}
+
+bool inferenceSchedulerUpdate(InferenceScheduler* scheduler, const float* mel_energies) {
+    // Профиль сцены и его отклонение от опорного в том же проходе
+    float change = 0;
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        float v = logf(1.0f + SCHEDULER_LOG_GAIN * mel_energies[mel]);
+        float scene = scheduler->primed
+            ? scheduler->scene_log_mel[mel] + SCHEDULER_SCENE_ALPHA * (v - scheduler->scene_log_mel[mel])
+            : v;
+        scheduler->scene_log_mel[mel] = scene;
+        change += fabsf(scene - scheduler->reference_log_mel[mel]);
+    }
+    scheduler->change = change / NUM_MELS;
+
+    // Первый кадр после сброса - опорный, инференс по нему сразу
+    if (!scheduler->primed) {
+        scheduler->primed = true;
+        scheduler->hops_since_inference = SCHEDULER_MAX_SKIP_HOPS;
+    }
+
+    if (++scheduler->hops_since_inference % SCHEDULER_STRIDE_HOPS != 0 &&
+        scheduler->hops_since_inference < SCHEDULER_MAX_SKIP_HOPS) {
+        return false;
+    }
+
+    scheduler->candidates++;
+    if (scheduler->change >= SCHEDULER_CHANGE_THRESHOLD ||
+        scheduler->hops_since_inference >= SCHEDULER_MAX_SKIP_HOPS) {
+        return true;
+    }
+    scheduler->skipped++;
+    return false;
+}
+
+void inferenceSchedulerMark(InferenceScheduler* scheduler) {
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        scheduler->reference_log_mel[mel] = scheduler->scene_log_mel[mel];
+    }
+    scheduler->hops_since_inference = 0;
+}
+
+float inferenceSchedulerSkipRatio(const InferenceScheduler& scheduler) {
+    return scheduler.candidates > 0 ? (float)scheduler.skipped / scheduler.candidates : 0.0f;
+}
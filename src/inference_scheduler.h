@@ -0,0 +1,46 @@
+#ifndef INFERENCE_SCHEDULER_H
+#define INFERENCE_SCHEDULER_H
+
+#include <stdint.h>
+#include "audio_processing.h"
+
+// Прореживание инференса в режиме скользящего окна (-DINFERENCE_SLIDING_WINDOW).
+// Кандидат на инференс - каждые SCHEDULER_STRIDE_HOPS шагов. Кандидат
+// пропускается, если профиль сцены (экспоненциальное среднее log-мель по
+// ~NUM_FRAMES кадрам) почти не изменился с последнего инференса:
+//   change = mean_mel |scene[m] - scene_at_last_inference[m]|
+// При изменении сцены инференс снова идет на каждом кандидате.
+// Дополнительная задержка обнаружения ограничена: не больше
+// SCHEDULER_STRIDE_HOPS шагов при change >= порога и не больше
+// SCHEDULER_MAX_SKIP_HOPS шагов для изменений ниже порога.
+// Не зависит от Arduino - порог настраивается на записях на хосте
+
+const int SCHEDULER_STRIDE_HOPS = 5;             // 50 мс - полная частота
+const int SCHEDULER_MAX_SKIP_HOPS = 50;          // 500 мс - граница задержки
+const float SCHEDULER_CHANGE_THRESHOLD = 0.1f;   // непер на полосу
+const float SCHEDULER_LOG_GAIN = 1000.0f;        // сжатие log(1 + g * m), как у детектора онсетов
+const float SCHEDULER_SCENE_ALPHA = 1.0f / NUM_FRAMES;
+
+struct InferenceScheduler {
+    float scene_log_mel[NUM_MELS];      // текущий профиль сцены
+    float reference_log_mel[NUM_MELS];  // профиль на момент последнего инференса
+    float change;                       // изменение на последнем кадре
+    bool primed;
+    int hops_since_inference;
+    uint32_t candidates;                // кандидатов с запуска
+    uint32_t skipped;                   // из них пропущено
+};
+
+void resetInferenceScheduler(InferenceScheduler* scheduler);
+
+// Обработка очередного кадра. true - на этом шаге нужен инференс
+bool inferenceSchedulerUpdate(InferenceScheduler* scheduler, const float* mel_energies);
+
+// Инференс выполнен (по решению планировщика или по онсету):
+// текущий профиль становится опорным
+void inferenceSchedulerMark(InferenceScheduler* scheduler);
+
+// Доля пропущенных кандидатов с запуска
+float inferenceSchedulerSkipRatio(const InferenceScheduler& scheduler);
+
+#endif // INFERENCE_SCHEDULER_H
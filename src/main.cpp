@@ -1,134 +1,189 @@
 #include <Arduino.h>
-#include "driver/i2s.h"
 #include <TensorFlowLite_ESP32.h>
-#include "tensorflow/lite/micro/all_ops_resolver.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "esp_ota_ops.h"
+#ifndef MODEL_PARTITION
 #include "model.h"  // Будет создан автоматически из .tflite файла
+#endif
 #include "audio_processing.h"
+#include "diagnostics.h"
+#include "memory_plan.h"
+#include "alloc_tracker.h"
+#include "audio_capture.h"
+#include "frontend_check.h"
+#include "frontend_parallel.h"
+#include "mel_stream.h"
+#include "onset_detector.h"
+#include "goertzel_bank.h"
+#include "inference_scheduler.h"
+#include "event_postprocessor.h"
+#include "streaming_model.h"
+#include "model_manager.h"
+#include "parallel_inference.h"
+#include "model_image.h"
+#include "model_hot_swap.h"
+#include "boot_profile.h"
+#ifdef MODEL_CASCADE
+#include "model_specialist.h"  // Специализированная модель для неоднозначных окон
+#endif
+#ifdef STREAMING_MODEL
+#include "model_streaming.h"  // Потоковый вариант модели с внешним состоянием сверток
+#endif
+#ifdef PARALLEL_INFERENCE
+#include "model_secondary.h"  // Второй детектор на тех же признаках, выполняется на ядре 0
+#endif
 
-// Дополнительные константы для аудио
-const int SAMPLE_BITS = 16;
-const int CHANNELS = 1;
-const int SPECTROGRAM_SIZE = 1960;  // 40 * 49 * 1 (обновлено под новую модель)
-
-// Буферы для аудио
-int16_t sampleBuffer[BUFFER_SIZE];
-float audioBuffer[BUFFER_SIZE];
-float spectrogram[SPECTROGRAM_SIZE];
+// Буферы конвейера (размещены в общем плане памяти, см. memory_plan.h)
+float* const spectrogram = g_pipeline_arena.spectrogram;
+FrontendWorkspace* const frontendWorkspace = &g_pipeline_arena.workspace;
 // int8_t quantized_spectrogram[SPECTROGRAM_SIZE];  // Убрано - не нужно для float32
 
+// Окно учета аллокаций (с первого шага после прошлого инференса)
+bool window_open = false;
+
+// Детектор онсетов и число шагов до окна, в котором онсет окажется
+// в кадре ONSET_WINDOW_FRAME (-1 - инференс не запланирован)
+OnsetDetector onset_detector;
+int hops_until_inference = -1;
+
+// Предварительный отбор (-DGOERTZEL_TRIGGER): фронтенд и модель работают
+// только после срабатывания банка Герцеля, см. goertzel_bank.h
+GoertzelBank goertzel_bank;
+uint32_t goertzel_cycles = 0;
+
+// Скользящее окно (-DINFERENCE_SLIDING_WINDOW): инференс прореживается
+// по изменению сцены, см. inference_scheduler.h
+InferenceScheduler scheduler;
+
+// Сглаживание оценок по окнам и события начала/конца по классам
+EventPostprocessor postprocessor;
+EventRecord event_records[EVENT_MAX_RECORDS];
+
+// Потоковая модель (-DSTREAMING_MODEL): инференс на каждом шаге по одному кадру,
+// состояние сверток переносится между вызовами Invoke()
+StreamingModel streaming_model;
+bool streaming_ready = false;
+
+// Новый поток мель-кадров: кольцо кадров и детектор начинают заново
+// (поток захвата не прерывался - например, после простоя банка Герцеля)
+void restartFrames() {
+    melStreamReset();
+    resetOnsetDetector(&onset_detector);
+    hops_until_inference = -1;
+    if (streaming_ready) {
+        streamingModelReset(&streaming_model);
+    }
+}
+
+// Разрыв потока захвата: заново начинают и кондиционирование отсчетов, и кадры
+void resetStream() {
+    captureResetStream();
+    restartFrames();
+}
+
 // Глобальные переменные для TensorFlow Lite
 tflite::MicroErrorReporter micro_error_reporter;
 tflite::ErrorReporter* error_reporter = &micro_error_reporter;
-const tflite::Model* model = nullptr;
-tflite::MicroInterpreter* interpreter = nullptr;
-TfLiteTensor* input = nullptr;
-TfLiteTensor* output = nullptr;
+
+// Образ модели во флеш-разделе (-DMODEL_PARTITION), отображен без копирования
+MappedModel mapped_model = {};
+
+// Модели в общей арене и каскад: общая модель, специализированная - по неоднозначным окнам
+ModelManager model_manager;
+ModelManager* models = &model_manager;  // Активный менеджер (при замене модели - один из двух)
+CascadePolicy cascade = {-1, -1, 0, 0};
 
 // Буфер для TensorFlow Lite
 constexpr int kTensorArenaSize = 200 * 1024;  // Увеличиваем для float32 модели
 uint8_t* tensor_arena = nullptr;  // Будет выделен в PSRAM
+#ifdef MODEL_HOT_SWAP
+ModelHotSwap hot_swap;
+uint8_t* standby_arena = nullptr;  // Вторая арена того же размера: в ней готовится новая модель
+#endif
+#ifdef STREAMING_MODEL
+constexpr int kStreamingArenaSize = 64 * 1024;  // Отдельная арена потоковой модели (PSRAM)
+uint8_t* streaming_arena = nullptr;
+#endif
+#ifdef PARALLEL_INFERENCE
+constexpr int kSecondaryArenaSize = 128 * 1024;  // Арена второго детектора на ядре 0 (PSRAM)
+uint8_t* secondary_arena = nullptr;
+#endif
 
 // Имена классов
-const char* class_names[] = {"Разбитие стекла", "Открытие двери", "Скрип пола"};
+const char* class_names[NUM_CLASSES] = {"Разбитие стекла", "Открытие двери", "Скрип пола"};
+
+// Вывод записей о начале и конце событий
+void reportEvents(int event_count) {
+    for (int e = 0; e < event_count; e++) {
+        const EventRecord& record = event_records[e];
+        DIAG_RESULT(record.start ? "\n🎯 НАЧАЛО СОБЫТИЯ: " : "\n⏹ КОНЕЦ СОБЫТИЯ: ");
+        DIAG_RESULT(class_names[record.class_index]);
+        DIAG_RESULT(" (шаг ");
+        DIAG_RESULT(record.hop);
+        if (record.start) {
+            DIAG_RESULT(", уверенность: ");
+        } else {
+            DIAG_RESULT(", длительность ");
+            DIAG_RESULT(record.duration_hops * HOP_LENGTH * 1000 / SAMPLE_RATE);
+            DIAG_RESULT(" мс, пик: ");
+        }
+        DIAG_RESULT(record.score, 4);
+        DIAG_RESULTLN(")");
+        (void)record;  // При DIAG_LEVEL < RESULT события никуда не выводятся
+    }
+}
+
+// Общая модель на ядре 1 (для замера параллельного инференса)
+TfLiteStatus runGeneralModel(const float* input) {
+    float scores[NUM_CLASSES];
+    return modelManagerInvoke(models, cascade.general, input, SPECTROGRAM_SIZE, scores);
+}
 
-// Конфигурация I2S для PDM микрофона (обновленная)
-const i2s_config_t i2s_config = {
-    .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM),
-    .sample_rate = SAMPLE_RATE,
-    .bits_per_sample = (i2s_bits_per_sample_t)SAMPLE_BITS,
-    .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
-    .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-    .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-    .dma_buf_count = 4,  // Уменьшаем количество буферов
-    .dma_buf_len = 256,  // Увеличиваем размер буфера
-    .use_apll = false,
-    .tx_desc_auto_clear = false,
-    .fixed_mclk = 0
+// Сведения о модели и тензорах для отчета. Копия, а не указатели на тензоры:
+// при быстром старте отчет печатается позже, когда арена может быть занята
+// другой моделью каскада
+struct TensorSummary {
+    TfLiteType type;
+    int num_dims;
+    int dims[4];
+    bool quantized;
 };
 
-// Конфигурация пинов I2S для XIAO ESP32S3
-const i2s_pin_config_t pin_config = {
-    .mck_io_num = I2S_PIN_NO_CHANGE,
-    .bck_io_num = I2S_PIN_NO_CHANGE,  // PDM Clock - встроенный
-    .ws_io_num = I2S_PIN_NO_CHANGE,   // PDM Data - встроенный
-    .data_out_num = I2S_PIN_NO_CHANGE,
-    .data_in_num = I2S_PIN_NO_CHANGE  // Используем встроенный PDM микрофон
+struct ModelInfo {
+    const tflite::Model* model;
+    TensorSummary input;
+    TensorSummary output;
 };
+ModelInfo model_info;
 
-void setup() {
-    Serial.begin(115200);
-    while (!Serial) delay(10);
-    
-    Serial.println("Инициализация...");
-    
-    // Проверка наличия PSRAM
-    if (!psramFound()) {
-        Serial.println("Ошибка: PSRAM не найден!");
-        return;
-    }
-    
-    // Выделение памяти для TensorFlow в PSRAM
-    tensor_arena = (uint8_t*)ps_malloc(kTensorArenaSize);
-    if (tensor_arena == nullptr) {
-        Serial.println("Ошибка выделения памяти для TensorFlow!");
-        return;
-    }
-    
-    // Инициализация I2S для PDM микрофона
-    esp_err_t err = i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
-    if (err != ESP_OK) {
-        Serial.println("Ошибка инициализации I2S!");
-        return;
-    }
-    
-    err = i2s_set_pin(I2S_NUM_0, &pin_config);
-    if (err != ESP_OK) {
-        Serial.println("Ошибка настройки пинов I2S!");
-        return;
-    }
-    
-    // Загрузка модели
-    model = tflite::GetModel(g_model);
-    if (model->version() != TFLITE_SCHEMA_VERSION) {
-        Serial.println("Несовместимая версия схемы модели!");
-        return;
+TensorSummary summarizeTensor(const TfLiteTensor* tensor) {
+    TensorSummary summary;
+    summary.type = tensor->type;
+    summary.num_dims = tensor->dims->size < 4 ? tensor->dims->size : 4;
+    for (int i = 0; i < summary.num_dims; i++) {
+        summary.dims[i] = tensor->dims->data[i];
     }
-    
-    // Создание интерпретатора со всеми операциями
-    static tflite::AllOpsResolver resolver;
-    
-    static tflite::MicroInterpreter static_interpreter(
-        model, resolver, tensor_arena, kTensorArenaSize, error_reporter);
-    interpreter = &static_interpreter;
-    
-    // Выделение тензоров
-    TfLiteStatus allocate_status = interpreter->AllocateTensors();
-    if (allocate_status != kTfLiteOk) {
-        Serial.println("Ошибка выделения тензоров!");
-        return;
-    }
-    
-    // Получение указателей на входной и выходной тензоры
-    input = interpreter->input(0);
-    output = interpreter->output(0);
-    
-    // Проверка входного тензора
-    if (input == nullptr) {
-        Serial.println("Ошибка: входной тензор не найден!");
-        return;
-    }
-    
-    // Вывод подробной информации о модели и тензорах
+    summary.quantized = tensor->quantization.type == kTfLiteAffineQuantization;
+    return summary;
+}
+
+// Вывод подробной информации о модели и тензорах
+void reportModelInfo() {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+#ifdef MODEL_HOT_SWAP
+    reportModelImage(modelHotSwapImage(hot_swap));
+#elif defined(MODEL_PARTITION)
+    reportModelImage(mapped_model);
+#endif
     Serial.println("\nИнформация о модели:");
     Serial.print("Количество операций: ");
-    Serial.println(model->subgraphs()->Get(0)->operators()->size());
+    Serial.println(model_info.model->subgraphs()->Get(0)->operators()->size());
     
     Serial.println("\nИнформация о входном тензоре:");
     Serial.print("Тип данных: ");
-    switch (input->type) {
+    switch (model_info.input.type) {
         case kTfLiteFloat32:
             Serial.println("kTfLiteFloat32");
             break;
@@ -143,15 +198,15 @@ void setup() {
     }
     
     Serial.print("Размеры: [");
-    for (int i = 0; i < input->dims->size; i++) {
-        Serial.print(input->dims->data[i]);
-        if (i < input->dims->size - 1) Serial.print(", ");
+    for (int i = 0; i < model_info.input.num_dims; i++) {
+        Serial.print(model_info.input.dims[i]);
+        if (i < model_info.input.num_dims - 1) Serial.print(", ");
     }
     Serial.println("]");
     
     // Получение параметров квантования
     Serial.println("\nПараметры входного тензора:");
-    if (input->quantization.type == kTfLiteAffineQuantization) {
+    if (model_info.input.quantized) {
         Serial.println("Квантование обнаружено (но не используется для float32)");
     } else {
         Serial.println("Квантование НЕ используется - входные данные float32");
@@ -160,7 +215,7 @@ void setup() {
     // Информация о выходном тензоре
     Serial.println("\nИнформация о выходном тензоре:");
     Serial.print("Тип: ");
-    switch (output->type) {
+    switch (model_info.output.type) {
         case kTfLiteFloat32:
             Serial.println("kTfLiteFloat32");
             break;
@@ -171,24 +226,241 @@ void setup() {
             Serial.println("Другой");
     }
     Serial.print("Размеры: [");
-    for (int i = 0; i < output->dims->size; i++) {
-        Serial.print(output->dims->data[i]);
-        if (i < output->dims->size - 1) Serial.print(", ");
+    for (int i = 0; i < model_info.output.num_dims; i++) {
+        Serial.print(model_info.output.dims[i]);
+        if (i < model_info.output.num_dims - 1) Serial.print(", ");
     }
     Serial.println("]");
-    
+#endif
+}
+
+void reportClassNames() {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
     Serial.println("\nКлассы для распознавания:");
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < NUM_CLASSES; i++) {
         Serial.print(i); Serial.print(": "); Serial.println(class_names[i]);
     }
+#endif
+}
+
+// Отложенный отчет быстрого старта (выполняется фоновой задачей)
+void reportBootDiagnostics() {
+    reportModelInfo();
+    reportClassNames();
+}
+
+// Отпечаток модели для записи плана: CRC образа из раздела или SHA прошивки
+// со встроенной моделью
+uint32_t modelFingerprint() {
+#ifdef MODEL_HOT_SWAP
+    return modelHotSwapImage(hot_swap).header->model_crc;
+#elif defined(MODEL_PARTITION)
+    return mapped_model.header->model_crc;
+#else
+    const uint8_t* sha = esp_ota_get_app_description()->app_elf_sha256;
+    return sha[0] | sha[1] << 8 | sha[2] << 16 | (uint32_t)sha[3] << 24;
+#endif
+}
+
+// Шаг потоковой модели: последний готовый кадр потока (столбец окна)
+void runStreamingStep() {
+    float frame[NUM_FEATURES];
+    melStreamLastFrame(frame);
+    TfLiteStatus status = streamingModelStep(&streaming_model, frame);
+    if (status != kTfLiteOk) {
+        DIAG_ERRORLN("Ошибка инференса потоковой модели!");
+        return;
+    }
+    reportEvents(eventPostprocessorUpdate(&postprocessor, streaming_model.scores->data.f, captureHopCount(),
+                                          event_records));
+}
+
+void setup() {
+    bootMark(BOOT_SETUP_START);
+#ifdef MODEL_HOT_SWAP
+    // Образы модели приходят по тому же порту (model_hot_swap.h): сектор целиком
+    Serial.setRxBufferSize(MODEL_WRITE_RX_BUFFER);
+#endif
+#if DIAG_ENABLED(DIAG_LEVEL_ERROR) || defined(MODEL_HOT_SWAP)
+    Serial.begin(115200);
+#endif
+#if DIAG_ENABLED(DIAG_LEVEL_ERROR) && !defined(FAST_BOOT)
+    while (!Serial) delay(10);
+#endif
+    
+    DIAG_INFOLN("Инициализация...");
+    
+    // setup() и loop() выполняются в одной задаче Arduino
+    stackBudgetRegisterTask(nullptr, CONFIG_ARDUINO_LOOP_STACK_SIZE, PIPELINE_STACK_BUDGET);
+    
+    // Проверка наличия PSRAM
+    if (!psramFound()) {
+        DIAG_ERRORLN("Ошибка: PSRAM не найден!");
+        return;
+    }
+    
+    // Выделение памяти для TensorFlow в PSRAM
+    tensor_arena = (uint8_t*)ps_malloc(kTensorArenaSize);
+    if (tensor_arena == nullptr) {
+        DIAG_ERRORLN("Ошибка выделения памяти для TensorFlow!");
+        return;
+    }
+    
+    // Инициализация I2S для PDM микрофона (DMA-геометрия из HOP_LENGTH;
+    // при CAPTURE_SAMPLE_RATE - еще и ресемплер)
+    esp_err_t err = captureBegin();
+    if (err != ESP_OK) {
+        DIAG_ERROR("Ошибка инициализации I2S: ");
+        DIAG_ERRORLN(esp_err_to_name(err));
+        return;
+    }
+    bootMark(BOOT_CAPTURE_STARTED);
+    
+    // Таблицы фронтенда и выбор вычислительного бэкенда
+    initFrontend();
+    DIAG_INFO("Бэкенд фронтенда: ");
+    DIAG_INFOLN(frontendBackendName());
+    reportCaptureResampler();
+    
+    resetStream();
+    goertzelBankBegin(&goertzel_bank, GOERTZEL_TARGET_HZ, GOERTZEL_NUM_TARGETS);
+    resetInferenceScheduler(&scheduler);
+    resetEventPostprocessor(&postprocessor);
+    
+    // Вторая половина кадров окна считается на ядре 0
+    if (!frontendParallelBegin(&g_pipeline_arena.worker_workspace)) {
+        DIAG_ERRORLN("Не удалось запустить задачу фронтенда на ядре 0, окно считается на одном ядре");
+    }
+    
+#ifdef FAST_BOOT
+    // План прошлой загрузки - только для сравнения в отчете загрузки
+    BootPlanRecord last_plan;
+    bootPlanLoad(&last_plan);
+#endif
+    uint32_t load_start = micros();
+    
+#ifdef MODEL_HOT_SWAP
+    // Модель из раздела с более новой версией; второй раздел - для замены без перезагрузки
+#ifdef MODEL_CASCADE
+    const void* specialist_data = g_specialist_model;
+#else
+    const void* specialist_data = nullptr;
+#endif
+    standby_arena = (uint8_t*)ps_malloc(kTensorArenaSize);
+    if (standby_arena == nullptr ||
+        !modelHotSwapBegin(&hot_swap, tensor_arena, standby_arena, kTensorArenaSize, error_reporter, specialist_data)) {
+        DIAG_ERRORLN("Ошибка загрузки модели из раздела!");
+        return;
+    }
+    models = modelHotSwapActive(&hot_swap);
+    cascade.general = hot_swap.general;
+    cascade.specialist = hot_swap.specialist_index;
+#else
+    // Загрузка моделей: резолвер каждой строится по ее собственным операциям,
+    // тензоры всех моделей по очереди размещаются в одной арене
+    modelManagerBegin(&model_manager, tensor_arena, kTensorArenaSize, error_reporter);
+#ifdef MODEL_PARTITION
+    if (!modelPartitionMap(modelPartitionFind(MODEL_PARTITION_LABEL), &mapped_model)) {
+        DIAG_ERRORLN("Ошибка загрузки модели из раздела!");
+        return;
+    }
+    const void* general_model_data = mapped_model.model_data;
+#else
+    const void* general_model_data = g_model;
+#endif
+    cascade.general = modelManagerAdd(&model_manager, "general", general_model_data);
+    if (cascade.general < 0) {
+        DIAG_ERRORLN("Ошибка загрузки модели!");
+        return;
+    }
+#ifdef MODEL_CASCADE
+    cascade.specialist = modelManagerAdd(&model_manager, "specialist", g_specialist_model);
+    if (cascade.specialist < 0) {
+        DIAG_ERRORLN("Специализированная модель недоступна, каскад из одной модели");
+    }
+#endif
+#endif
+    
+    // Тензоры общей модели размещаются первыми
+    tflite::MicroInterpreter* interpreter = modelManagerActivate(models, cascade.general);
+    if (interpreter == nullptr) {
+        DIAG_ERRORLN("Ошибка выделения тензоров!");
+        return;
+    }
+    uint32_t load_us = micros() - load_start;
+    
+    // Получение указателей на входной и выходной тензоры
+    TfLiteTensor* input = interpreter->input(0);
+    TfLiteTensor* output = interpreter->output(0);
+    
+    // Проверка входного тензора
+    if (input == nullptr || output == nullptr) {
+        DIAG_ERRORLN("Ошибка: входной тензор не найден!");
+        return;
+    }
+    model_info.model = models->models[cascade.general].model;
+    model_info.input = summarizeTensor(input);
+    model_info.output = summarizeTensor(output);
+    bootPlanSet({modelFingerprint(), (uint32_t)interpreter->arena_used_bytes(), load_us});
+    bootMark(BOOT_MODEL_READY);
+    
+#ifdef STREAMING_MODEL
+    // Потоковая модель в своей арене; без нее работает оконный режим
+    streaming_arena = (uint8_t*)ps_malloc(kStreamingArenaSize);
+    static ModelOpResolver streaming_resolver;
+    const tflite::Model* streaming_model_data = tflite::GetModel(g_streaming_model);
+    if (streaming_arena != nullptr && buildOpResolver(streaming_model_data, &streaming_resolver)) {
+        static tflite::MicroInterpreter streaming_interpreter(
+            streaming_model_data, streaming_resolver, streaming_arena, kStreamingArenaSize, error_reporter);
+        streaming_ready = streaming_interpreter.AllocateTensors() == kTfLiteOk &&
+                          streamingModelBegin(&streaming_model, &streaming_interpreter);
+    }
+    if (!streaming_ready) {
+        DIAG_ERRORLN("Потоковая модель недоступна, инференс по окнам");
+    }
+#endif
+    
+#ifdef PARALLEL_INFERENCE
+    // Второй детектор в своей арене на ядре 0; без него работает только каскад на ядре 1
+    secondary_arena = (uint8_t*)ps_malloc(kSecondaryArenaSize);
+    static ModelOpResolver secondary_resolver;
+    const tflite::Model* secondary_model = tflite::GetModel(g_secondary_model);
+    if (secondary_arena == nullptr || !buildOpResolver(secondary_model, &secondary_resolver) ||
+        !parallelInferenceBegin(secondary_model, secondary_resolver, secondary_arena, kSecondaryArenaSize,
+                                error_reporter, SPECTROGRAM_SIZE)) {
+        DIAG_ERRORLN("Второй детектор недоступен, инференс на одном ядре");
+    }
+#endif
+    
+#ifdef FAST_BOOT
+    // Сразу к захвату: информация о модели - в фоне после первого инференса,
+    // тесты бэкендов и микрофона пропускаются
+    if (!bootReportBegin(reportBootDiagnostics)) {
+        DIAG_ERRORLN("Фоновый отчет о загрузке не запущен");
+    }
+#elif DIAG_ENABLED(DIAG_LEVEL_INFO)
+    reportModelInfo();
+    
+    // Такты на кадр и сверка бэкендов фронтенда со скалярным эталоном
+    reportFrontendBackends(frontendWorkspace);
+    reportFrontendParallel(captureRing(), CAPTURE_RING_SIZE, spectrogram, frontendWorkspace);
+    if (streaming_ready) {
+        reportStreamingModelParity(&streaming_model, interpreter, spectrogram);
+    }
+    if (parallelInferenceEnabled()) {
+        reportParallelInference(spectrogram, runGeneralModel, interpreter->arena_used_bytes());
+    }
+    
+    reportClassNames();
     
     // Тестирование микрофона
     Serial.println("\n=== ТЕСТИРОВАНИЕ МИКРОФОНА ===");
     Serial.println("Тестируем I2S и PDM микрофон...");
     
+    // Тестовое чтение идет в кольцо захвата (оно еще пустое), а не на стек
     size_t test_bytes_read = 0;
-    int16_t test_buffer[256];
-    esp_err_t test_err = i2s_read(I2S_NUM_0, test_buffer, sizeof(test_buffer), &test_bytes_read, 1000);
+    int16_t* test_buffer = g_pipeline_arena.capture_ring;
+    esp_err_t test_err = i2s_read(CAPTURE_I2S_PORT, test_buffer, 256 * sizeof(int16_t), &test_bytes_read, 1000);
     
     if (test_err == ESP_OK && test_bytes_read > 0) {
         int16_t test_max = 0, test_min = 0;
@@ -221,137 +493,236 @@ void setup() {
     Serial.println("- Открыть/закрыть дверь");
     Serial.println("- Скрипнуть половицей или мебелью");
     Serial.println("=====================================\n");
+#endif
 }
 
 void loop() {
-    size_t bytes_read = 0;
-    esp_err_t err = i2s_read(I2S_NUM_0, sampleBuffer, BUFFER_SIZE * sizeof(int16_t), &bytes_read, portMAX_DELAY);
+    if (!window_open) {
+        window_open = true;
+        allocTrackerWindowBegin();
+    }
     
-    if (err == ESP_OK && bytes_read > 0) {
-        // Детальная диагностика аудио потока
-        int16_t max_sample = 0;
-        int16_t min_sample = 0;
-        int32_t sum = 0;
-        int non_zero_count = 0;
+    // Захват одного шага прямо в кольцо фронтенда
+    esp_err_t err = captureReadHop(portMAX_DELAY);
+    
+    if (err == ESP_OK) {
+        // События заканчиваются и без нового окна (оценки затухают)
+        reportEvents(eventPostprocessorTick(&postprocessor, captureHopCount(), event_records));
         
-        for (int i = 0; i < BUFFER_SIZE; i++) {
-            if (sampleBuffer[i] > max_sample) max_sample = sampleBuffer[i];
-            if (sampleBuffer[i] < min_sample) min_sample = sampleBuffer[i];
-            sum += sampleBuffer[i];
-            if (sampleBuffer[i] != 0) non_zero_count++;
+#ifdef GOERTZEL_TRIGGER
+        // Предварительный отбор по целевым бинам. Срабатывание ставит инференс
+        // как онсет; без срабатывания кадры не считаются (только оценка шума,
+        // melStreamIdleHop), а по окончании активного состояния поток
+        // мель-кадров начинается заново (окно после срабатывания
+        // пересчитывается из кольца захвата)
+        bool was_active = goertzelBankActive(goertzel_bank);
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+        uint32_t goertzel_start = ESP.getCycleCount();
+#endif
+        bool triggered = goertzelBankUpdate(&goertzel_bank, captureRing() + captureTailStart(HOP_LENGTH), HOP_LENGTH);
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+        goertzel_cycles = ESP.getCycleCount() - goertzel_start;
+#endif
+        if (triggered && hops_until_inference < 0) {
+            hops_until_inference = ONSET_INFERENCE_DELAY_HOPS;
+            DIAG_VERBOSE("\nСрабатывание банка Герцеля, уровень: ");
+            DIAG_VERBOSELN(goertzel_bank.level, 1);
         }
+        if (!goertzelBankActive(goertzel_bank)) {
+            if (was_active) {
+                restartFrames();
+            }
+            melStreamIdleHop(frontendWorkspace);
+            return;
+        }
+#endif
         
-        float average = (float)sum / BUFFER_SIZE;
-        
-        Serial.print("\n=== ДИАГНОСТИКА АУДИО ===");
-        Serial.print("\nПрочитано байт: "); Serial.println(bytes_read);
-        Serial.print("Размер буфера: "); Serial.println(BUFFER_SIZE);
-        Serial.print("Max sample: "); Serial.println(max_sample);
-        Serial.print("Min sample: "); Serial.println(min_sample);
-        Serial.print("Среднее: "); Serial.println(average, 2);
-        Serial.print("Ненулевых сэмплов: "); Serial.print(non_zero_count);
-        Serial.print(" из "); Serial.println(BUFFER_SIZE);
-        
-        // Проверка вариативности данных
-        bool data_varies = (max_sample != min_sample) && (non_zero_count > BUFFER_SIZE / 10);
-        Serial.print("Данные изменяются: "); Serial.println(data_varies ? "ДА" : "НЕТ");
+        // Кадр нового шага и поиск онсета
+        bool scene_changed = false;
+        const float* mel_energies = melStreamPushHop(frontendWorkspace);
+        if (melStreamWindowReady()) {
+            bootMark(BOOT_WINDOW_READY);
+        }
         
-        if (!data_varies) {
-            Serial.println("⚠️  ПРОБЛЕМА: Аудио данные статичны или отсутствуют!");
-            Serial.println("Попробуйте:");
-            Serial.println("1. Издать громкий звук рядом с микрофоном");
-            Serial.println("2. Проверить подключение микрофона");
-            delay(1000);
+        // Потоковая модель обрабатывает каждый кадр сама, без окон
+        if (streaming_ready) {
+            if (mel_energies != nullptr) {
+                runStreamingStep();
+            }
+            window_open = false;
+            allocTrackerWindowEnd();
             return;
         }
         
-        // Преобразование аудио в мель-спектрограмму
-        for (int i = 0; i < BUFFER_SIZE; i++) {
-            audioBuffer[i] = sampleBuffer[i] / 32768.0f;
+        if (mel_energies != nullptr) {
+            if (onsetDetectorUpdate(&onset_detector, mel_energies) && hops_until_inference < 0) {
+                hops_until_inference = ONSET_INFERENCE_DELAY_HOPS;
+                DIAG_VERBOSE("\nОнсет, спектральный поток: ");
+                DIAG_VERBOSELN(onset_detector.flux, 3);
+            }
+#ifdef INFERENCE_SLIDING_WINDOW
+            scene_changed = inferenceSchedulerUpdate(&scheduler, mel_energies);
+#endif
         }
         
-        Serial.println("\nВычисляем спектрограмму...");
-        audioToMelSpectrogram(audioBuffer, spectrogram);
+        // Инференс в окне, где онсет стоит в кадре ONSET_WINDOW_FRAME,
+        // а в режиме скользящего окна - еще и по изменению сцены
+        bool run_inference = scene_changed;
+        if (hops_until_inference > 0) {
+            hops_until_inference--;
+        } else if (hops_until_inference == 0) {
+            hops_until_inference = -1;
+            run_inference = true;
+        }
+        if (!run_inference) {
+            return;
+        }
+        window_open = false;
+        inferenceSchedulerMark(&scheduler);
+#ifdef MODEL_HOT_SWAP
+        // Подготовленная в фоне модель подхватывается только между окнами
+        models = modelHotSwapPoll(&hot_swap);
+#endif
+        uint32_t inference_start_ms = millis();
         
-        // Анализ спектрограммы
-        float min_spec = 1000.0f, max_spec = -1000.0f;
-        float spec_sum = 0;
-        int non_zero_spec = 0;
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+        uint32_t window_start_cycles = ESP.getCycleCount();
+#endif
+
+        // Проверка вариативности данных окна (статистика собрана при захвате шагов)
+        Int16Stats audio_stats;
+        captureWindowStats(&audio_stats);
+        bool data_varies = (audio_stats.max != audio_stats.min) && (audio_stats.count_above > audio_stats.count / 10);
         
-        for (int i = 0; i < SPECTROGRAM_SIZE; i++) {
-            if (spectrogram[i] < min_spec) min_spec = spectrogram[i];
-            if (spectrogram[i] > max_spec) max_spec = spectrogram[i];
-            spec_sum += spectrogram[i];
-            if (spectrogram[i] > 0.001f) non_zero_spec++;
+#if DIAG_ENABLED(DIAG_LEVEL_VERBOSE)
+        // Детальная диагностика аудио потока
+        Serial.print("\n=== ДИАГНОСТИКА АУДИО ===");
+        Serial.print("\nПрочитано байт: "); Serial.println(audio_stats.count * sizeof(int16_t));
+        Serial.print("Размер окна: "); Serial.println(audio_stats.count);
+        Serial.print("Max sample: "); Serial.println(audio_stats.max);
+        Serial.print("Min sample: "); Serial.println(audio_stats.min);
+        Serial.print("Среднее: "); Serial.println(statsMean(audio_stats), 2);
+        Serial.print("RMS: "); Serial.println(statsRms(audio_stats), 2);
+        Serial.print("Ненулевых сэмплов: "); Serial.print(audio_stats.count_above);
+        Serial.print(" из "); Serial.println(audio_stats.count);
+        Serial.print("Данные изменяются: "); Serial.println(data_varies ? "ДА" : "НЕТ");
+#endif
+        
+        if (!data_varies) {
+            DIAG_VERBOSELN("⚠️  ПРОБЛЕМА: Аудио данные статичны или отсутствуют!");
+            DIAG_VERBOSELN("Попробуйте:");
+            DIAG_VERBOSELN("1. Издать громкий звук рядом с микрофоном");
+            DIAG_VERBOSELN("2. Проверить подключение микрофона");
+            allocTrackerWindowEnd();
+            delay(1000);
+            resetStream();
+            return;
         }
         
-        float spec_avg = spec_sum / SPECTROGRAM_SIZE;
+        // Спектрограмма окна: из кольца мель-кадров, а если кольцо еще
+        // не заполнено после разрыва потока - полным пересчетом на двух ядрах
+        DIAG_VERBOSELN("\nВычисляем спектрограмму...");
+        FloatStats spec_stats;
+        if (melStreamWindowReady()) {
+            melStreamToSpectrogram(spectrogram, &spec_stats);
+        } else {
+            audioToMelSpectrogramParallel(captureRing(), CAPTURE_RING_SIZE, captureWindowStart(),
+                                          spectrogram, frontendWorkspace, &spec_stats);
+        }
         
+#if DIAG_ENABLED(DIAG_LEVEL_VERBOSE)
+        // Анализ спектрограммы (статистика собрана при нормализации)
         Serial.println("=== АНАЛИЗ СПЕКТРОГРАММЫ ===");
-        Serial.print("Min: "); Serial.println(min_spec, 4);
-        Serial.print("Max: "); Serial.println(max_spec, 4);
-        Serial.print("Среднее: "); Serial.println(spec_avg, 4);
-        Serial.print("Значимых значений: "); Serial.print(non_zero_spec);
+        Serial.print("Min: "); Serial.println(spec_stats.min, 4);
+        Serial.print("Max: "); Serial.println(spec_stats.max, 4);
+        Serial.print("Среднее: "); Serial.println(statsMean(spec_stats), 4);
+        Serial.print("Значимых значений: "); Serial.print(spec_stats.count_above);
         Serial.print(" из "); Serial.println(SPECTROGRAM_SIZE);
+#endif
         
-        // Проверяем тип входного тензора
-        if (input->type == kTfLiteFloat32) {
-            Serial.println("\nКопируем float32 данные...");
-            memcpy(input->data.f, spectrogram, SPECTROGRAM_SIZE * sizeof(float));
-        } else {
-            Serial.print("Неожиданный тип входного тензора: ");
-            Serial.println(input->type);
-            return;
+        // Каскад моделей: общая, при неоднозначных оценках - специализированная
+        DIAG_VERBOSELN("Запуск инференса...");
+        float scores[NUM_CLASSES];
+        bool secondary_running = parallelInferenceEnabled();
+        if (secondary_running) {
+            parallelInferenceStart(spectrogram);
         }
+        TfLiteStatus invoke_status = runCascade(models, &cascade, spectrogram, SPECTROGRAM_SIZE, scores);
 
-        // Запуск инференса
-        Serial.println("Запуск инференса...");
-        TfLiteStatus invoke_status = interpreter->Invoke();
+        // Второй детектор отвечает за свои классы (SECONDARY_CLASS_MAP):
+        // оценка такого класса - максимум двух детекторов
+        if (secondary_running) {
+            float secondary_scores[SECONDARY_NUM_OUTPUTS];
+            if (parallelInferenceWait(secondary_scores) != kTfLiteOk) {
+                DIAG_ERRORLN("Ошибка инференса второго детектора!");
+            } else {
+                parallelInferenceMerge(secondary_scores, scores);
+            }
+        }
         if (invoke_status != kTfLiteOk) {
-            Serial.println("Ошибка инференса!");
+            DIAG_ERRORLN("Ошибка инференса!");
+            allocTrackerWindowEnd();
             return;
         }
+        bootMark(BOOT_FIRST_INFERENCE);
 
-        // Получение результатов
-        float scores[3] = {0, 0, 0};
-        float max_score = -1000.0f;
-        int max_index = 0;
-        
-        for (int i = 0; i < 3; i++) {
-            scores[i] = output->data.f[i];
-            if (scores[i] > max_score) {
-                max_score = scores[i];
-                max_index = i;
-            }
-        }
+        // Сглаживание оценок и события по классам (окно заканчивается на текущем шаге)
+        int event_count = eventPostprocessorUpdate(&postprocessor, scores, captureHopCount(), event_records);
+
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+        uint32_t window_cycles = ESP.getCycleCount() - window_start_cycles;
 
-        // Вывод результатов
+        // Вывод результатов: оценка окна и сглаженная оценка
         Serial.println("\n=== РЕЗУЛЬТАТЫ РАСПОЗНАВАНИЯ ===");
-        for (int i = 0; i < 3; i++) {
+        for (int i = 0; i < NUM_CLASSES; i++) {
             Serial.print("  "); Serial.print(class_names[i]); 
-            Serial.print(": "); Serial.println(scores[i], 4);
+            Serial.print(": "); Serial.print(scores[i], 4);
+            Serial.print(" (сглаженная "); Serial.print(postprocessor.classes[i].smoothed, 4);
+            Serial.println(postprocessor.classes[i].active ? ", событие идет)" : ")");
         }
+        Serial.print("Тактов на окно: "); Serial.print(window_cycles);
+        Serial.print(" ("); Serial.print(millis() - inference_start_ms); Serial.println(" мс без отчета)");
+#ifdef INFERENCE_SLIDING_WINDOW
+        Serial.print("Изменение сцены: "); Serial.print(scheduler.change, 3);
+        Serial.print(", пропущено инференсов: "); Serial.print(inferenceSchedulerSkipRatio(scheduler) * 100, 1);
+        Serial.println("%");
+#endif
+#ifdef GOERTZEL_TRIGGER
+        Serial.print("Банк Герцеля: уровень "); Serial.print(goertzel_bank.level, 1);
+        Serial.print(", фон "); Serial.print(goertzel_bank.background, 1);
+        Serial.print(", срабатываний "); Serial.print(goertzel_bank.triggers);
+        Serial.print(", тактов на шаг "); Serial.println(goertzel_cycles);
+#endif
+        reportModelManager(*models, cascade);
+#ifdef MODEL_HOT_SWAP
+        reportModelHotSwap(hot_swap);
+#endif
+        reportMemoryPlan();
+        allocTrackerReport();
+#endif
         
-        Serial.print("\n🎯 РАСПОЗНАННЫЙ ЗВУК: ");
-        Serial.print(class_names[max_index]);
-        Serial.print(" (уверенность: ");
-        Serial.print(max_score, 4);
-        Serial.println(")");
-        
-        // Анализ уверенности
-        if (max_score < 0.3f) {
-            Serial.println("❓ Очень низкая уверенность - возможно, неизвестный звук");
-        } else if (max_score < 0.6f) {
-            Serial.println("⚠️  Низкая уверенность - нужен более четкий звук");
-        } else {
-            Serial.println("✅ Высокая уверенность в распознавании!");
-        }
+        reportEvents(event_count);
         
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
         Serial.println("==============================");
-        delay(2000); // Увеличиваем паузу для лучшей читаемости
+#endif
+        allocTrackerWindowEnd();
+        // Окно обрабатывалось дольше запаса DMA - часть шагов потеряна
+        uint32_t window_ms = millis() - inference_start_ms;
+        bool overrun = window_ms > (uint32_t)CAPTURE_SLACK_MS;
+        DIAG_INFO("Окно с отчетом: "); DIAG_INFO(window_ms);
+        DIAG_INFO(" мс, запас DMA: "); DIAG_INFO(CAPTURE_SLACK_MS);
+        DIAG_INFOLN(overrun ? " мс - шаги потеряны, поток начинается заново" : " мс");
+#ifdef MODEL_HOT_SWAP
+        modelHotSwapCountWindow(&hot_swap, overrun);
+#endif
+        if (overrun) {
+            resetStream();
+        }
     } else {
-        Serial.print("Ошибка чтения I2S: ");
-        Serial.println(esp_err_to_name(err));
+        DIAG_ERROR("Ошибка чтения I2S: ");
+        DIAG_ERRORLN(esp_err_to_name(err));
         delay(1000);
+        resetStream();
     }
-} 
\ No newline at end of file
+}
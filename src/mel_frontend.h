@@ -0,0 +1,269 @@
+#ifndef MEL_FRONTEND_H
+#define MEL_FRONTEND_H
+
+#include <stdint.h>
+#include "constexpr_math.h"
+#include "frontend_kernels.h"
+#include "frontend_kernels_scalar.h"
+
+// Мель-фронтенд с параметрами времени компиляции. Config - структура
+// со static constexpr полями:
+//
+//   struct KeywordFrontendConfig {
+//       static constexpr int SAMPLE_RATE = 16000;
+//       static constexpr int FFT_SIZE = 512;
+//       static constexpr int NUM_MELS = 40;
+//       static constexpr int NUM_FRAMES = 49;
+//       static constexpr int HOP_LENGTH = 160;
+//       static constexpr int MIN_FREQ = 20;
+//       static constexpr int MAX_FREQ = 8000;
+//   };
+//
+// Окно, поворачивающие множители, порядок бит-реверса и мель-веса вычисляются
+// компилятором и лежат в .rodata (на ESP32 - во flash): инициализация при
+// загрузке не нужна, DRAM под таблицы не расходуется. Каждая конфигурация -
+// отдельный экземпляр шаблона со своими таблицами, так что несколько
+// фронтендов (например, 16 кГц и 8 кГц) сосуществуют в одной прошивке
+
+// Массив, который можно построить constexpr-функцией
+template <typename T, int N>
+struct ConstexprTable {
+    T data[N];
+};
+
+// Окно Ханна
+template <int N>
+constexpr ConstexprTable<float, N> makeHannWindow() {
+    ConstexprTable<float, N> table = {};
+    for (int i = 0; i < N; i++) {
+        table.data[i] = (float)(0.5 * (1.0 - constexprCos(2.0 * CONSTEXPR_PI * i / (N - 1))));
+    }
+    return table;
+}
+
+// Поворачивающие множители по стадиям: стадия с полушириной half
+// использует exp(-2*pi*i * j / (2 * half)), j = 0..half-1
+template <int N>
+constexpr ConstexprTable<float, 2 * (N - 1)> makeFftTwiddles() {
+    ConstexprTable<float, 2 * (N - 1)> table = {};
+    for (int half = 1; half < N; half <<= 1) {
+        for (int j = 0; j < half; j++) {
+            table.data[2 * (half - 1) + 2 * j] = (float)constexprCos(CONSTEXPR_PI * j / half);
+            table.data[2 * (half - 1) + 2 * j + 1] = (float)-constexprSin(CONSTEXPR_PI * j / half);
+        }
+    }
+    return table;
+}
+
+// Порядок бит-реверса для входа бабочек DIT
+template <int N>
+constexpr ConstexprTable<uint16_t, N> makeBitReverse() {
+    ConstexprTable<uint16_t, N> table = {};
+    int bits = 0;
+    while ((1 << bits) < N) {
+        bits++;
+    }
+    for (int i = 0; i < N; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        table.data[i] = (uint16_t)reversed;
+    }
+    return table;
+}
+
+// Границы треугольных мель-фильтров в бинах FFT (NUM_MELS + 2 точки)
+template <class Config>
+constexpr ConstexprTable<int, Config::NUM_MELS + 2> makeMelBandEdges() {
+    ConstexprTable<int, Config::NUM_MELS + 2> table = {};
+    double mel_min = 2595.0 * constexprLog10(1.0 + Config::MIN_FREQ / 700.0);
+    double mel_max = 2595.0 * constexprLog10(1.0 + Config::MAX_FREQ / 700.0);
+    double mel_step = (mel_max - mel_min) / (Config::NUM_MELS + 1);
+    for (int i = 0; i < Config::NUM_MELS + 2; i++) {
+        double hz = 700.0 * (constexprPow10((mel_min + i * mel_step) / 2595.0) - 1.0);
+        table.data[i] = constexprRound(hz * Config::FFT_SIZE / Config::SAMPLE_RATE);
+    }
+    return table;
+}
+
+// Конец полосы фильтра i (без бинов выше Найквиста)
+template <class Config>
+constexpr int melBandEnd(const ConstexprTable<int, Config::NUM_MELS + 2>& edges, int i) {
+    return edges.data[i + 2] < Config::FFT_SIZE / 2 ? edges.data[i + 2] : Config::FFT_SIZE / 2;
+}
+
+// Число ненулевых весов всех фильтров
+template <class Config>
+constexpr int melWeightCount() {
+    constexpr ConstexprTable<int, Config::NUM_MELS + 2> edges = makeMelBandEdges<Config>();
+    int count = 0;
+    for (int i = 0; i < Config::NUM_MELS; i++) {
+        int end = melBandEnd<Config>(edges, i);
+        count += end > edges.data[i] ? end - edges.data[i] : 0;
+    }
+    return count > 0 ? count : 1;
+}
+
+// Разреженная мель-банка (см. MelFilterbank в frontend_kernels.h)
+template <int NUM_MELS, int NUM_WEIGHTS>
+struct MelFilterbankTable {
+    int16_t start[NUM_MELS];
+    int16_t length[NUM_MELS];
+    int16_t offset[NUM_MELS];
+    float weights[NUM_WEIGHTS];
+};
+
+template <class Config>
+constexpr MelFilterbankTable<Config::NUM_MELS, melWeightCount<Config>()> makeMelFilterbank() {
+    constexpr ConstexprTable<int, Config::NUM_MELS + 2> edges = makeMelBandEdges<Config>();
+    MelFilterbankTable<Config::NUM_MELS, melWeightCount<Config>()> table = {};
+    const int* bin = edges.data;
+    int offset = 0;
+    for (int i = 0; i < Config::NUM_MELS; i++) {
+        int end = melBandEnd<Config>(edges, i);
+        table.start[i] = (int16_t)bin[i];
+        table.offset[i] = (int16_t)offset;
+        table.length[i] = (int16_t)(end > bin[i] ? end - bin[i] : 0);
+
+        for (int j = bin[i]; j < end; j++) {
+            float weight = 0;
+            if (j < bin[i + 1]) {
+                weight = (float)(j - bin[i]) / (bin[i + 1] - bin[i]);
+            } else {
+                weight = (float)(bin[i + 2] - j) / (bin[i + 2] - bin[i + 1]);
+            }
+            table.weights[offset++] = weight;
+        }
+    }
+    return table;
+}
+
+// Матрица DCT-II (ортонормированная) для MFCC в формате MelFilterbank: строка
+// k - полный "фильтр" по всем NUM_BANDS полосам, так что MFCC считаются тем же
+// ядром melMac, что и мель-энергии. В веса вложены лифтер
+// 1 + (LIFTER / 2) * sin(pi * k / LIFTER) (LIFTER = 0 - без лифтера) и множитель
+// ln2 (вход - log2 энергий, выход - кепстр натурального логарифма)
+template <int NUM_COEFFS, int NUM_BANDS, int LIFTER>
+constexpr MelFilterbankTable<NUM_COEFFS, NUM_COEFFS * NUM_BANDS> makeDctFilterbank() {
+    MelFilterbankTable<NUM_COEFFS, NUM_COEFFS * NUM_BANDS> table = {};
+    for (int k = 0; k < NUM_COEFFS; k++) {
+        table.start[k] = 0;
+        table.length[k] = (int16_t)NUM_BANDS;
+        table.offset[k] = (int16_t)(k * NUM_BANDS);
+        double norm = k == 0 ? constexprExp(0.5 * constexprLog(1.0 / NUM_BANDS))
+                             : constexprExp(0.5 * constexprLog(2.0 / NUM_BANDS));
+        double lifter = LIFTER > 0 ? 1.0 + 0.5 * LIFTER * constexprSin(CONSTEXPR_PI * k / (LIFTER > 0 ? LIFTER : 1)) : 1.0;
+        for (int n = 0; n < NUM_BANDS; n++) {
+            double basis = constexprCos(CONSTEXPR_PI * k * (n + 0.5) / NUM_BANDS);
+            table.weights[k * NUM_BANDS + n] = (float)(norm * lifter * CONSTEXPR_LN2 * basis);
+        }
+    }
+    return table;
+}
+
+template <class Config>
+class MelFrontend {
+public:
+    static constexpr int SAMPLE_RATE = Config::SAMPLE_RATE;
+    static constexpr int FFT_SIZE = Config::FFT_SIZE;
+    static constexpr int NUM_BINS = FFT_SIZE / 2;
+    static constexpr int NUM_MELS = Config::NUM_MELS;
+    static constexpr int NUM_FRAMES = Config::NUM_FRAMES;
+    static constexpr int HOP_LENGTH = Config::HOP_LENGTH;
+    static constexpr int WINDOW_SAMPLES = (NUM_FRAMES - 1) * HOP_LENGTH + FFT_SIZE;
+    static constexpr int SPECTROGRAM_SIZE = NUM_MELS * NUM_FRAMES;
+
+    static_assert(FFT_SIZE >= 2 && (FFT_SIZE & (FFT_SIZE - 1)) == 0, "FFT_SIZE должен быть степенью двойки");
+    static_assert(FFT_SIZE <= 32768, "индексы бинов хранятся в int16");
+    static_assert(Config::MIN_FREQ < Config::MAX_FREQ && Config::MAX_FREQ * 2 <= SAMPLE_RATE,
+                  "полоса мель-фильтров должна лежать ниже частоты Найквиста");
+
+    // Рабочая память фронтенда. Живет только во время вычисления спектрограммы,
+    // поэтому размещается вызывающей стороной, а не на стеке
+    struct Workspace {
+        float fft_buffer[FFT_SIZE];       // кадр, затем магнитуды
+        float fft_data[2 * FFT_SIZE];     // комплексный спектр (re, im)
+        float mel_energies[NUM_MELS];
+    };
+
+    // Таблицы, построенные компилятором
+    static constexpr ConstexprTable<float, FFT_SIZE> window = makeHannWindow<FFT_SIZE>();
+    static constexpr ConstexprTable<float, 2 * (FFT_SIZE - 1)> twiddles = makeFftTwiddles<FFT_SIZE>();
+    static constexpr ConstexprTable<uint16_t, FFT_SIZE> bit_reverse = makeBitReverse<FFT_SIZE>();
+    static constexpr MelFilterbankTable<NUM_MELS, melWeightCount<Config>()> mel = makeMelFilterbank<Config>();
+    static constexpr MelFilterbank filterbank = {mel.start, mel.length, mel.offset, mel.weights, NUM_MELS};
+
+    // Один кадр: окно -> FFT -> магнитуды -> мель-энергии (с вычитанием шума
+    // suppressor в том же проходе, nullptr - без вычитания).
+    // Вход - workspace->fft_buffer, выход - workspace->mel_energies.
+    // Скалярный бэкенд встраивается с размерами времени компиляции,
+    // остальные вызываются через таблицу бэкенда
+    static void computeFrame(const FrontendBackend* backend, Workspace* workspace,
+                             const MelNoiseSuppressor* suppressor = nullptr) {
+        if (backend == &kScalarFrontendBackend) {
+            windowScalar(workspace->fft_buffer, window.data, workspace->fft_data, FFT_SIZE);
+            fftScalar(workspace->fft_data, twiddles.data, bit_reverse.data, FFT_SIZE);
+            magnitudeScalar(workspace->fft_data, workspace->fft_buffer, NUM_BINS);
+            melMacScalar(workspace->fft_buffer, &filterbank, workspace->mel_energies, suppressor);
+            return;
+        }
+        backend->window(workspace->fft_buffer, window.data, workspace->fft_data, FFT_SIZE);
+        backend->fft(workspace->fft_data, twiddles.data, bit_reverse.data, FFT_SIZE);
+        backend->magnitude(workspace->fft_data, workspace->fft_buffer, NUM_BINS);
+        backend->melMac(workspace->fft_buffer, &filterbank, workspace->mel_energies, suppressor);
+    }
+
+    // Загрузка кадра FFT_SIZE из кольцевого буфера с преобразованием int16 -> float
+    static void loadFrame(const int16_t* audio, int audio_size, int start, float* frame) {
+        const float scale = 1.0f / 32768.0f;
+        int first = audio_size - start;
+        if (first > FFT_SIZE) {
+            first = FFT_SIZE;
+        }
+
+        for (int i = 0; i < first; i++) {
+            frame[i] = audio[start + i] * scale;
+        }
+        for (int i = first; i < FFT_SIZE; i++) {
+            frame[i] = audio[i - first] * scale;
+        }
+    }
+
+    // Кадры [first_frame, end_frame) окна из кольцевого буфера без нормализации
+    // (раскладка mel * NUM_FRAMES + frame). Возвращает их максимум. Разные
+    // диапазоны кадров пишут в непересекающиеся ячейки и могут считаться
+    // параллельно, каждый со своей рабочей областью
+    static float computeFrames(const FrontendBackend* backend, const int16_t* audio, int audio_size,
+                               int start, float* spectrogram, Workspace* workspace,
+                               int first_frame, int end_frame,
+                               const MelNoiseSuppressor* suppressor = nullptr) {
+        float max_val = 0;
+
+        for (int frame = first_frame; frame < end_frame; frame++) {
+            int frame_start = start + frame * HOP_LENGTH;
+            if (frame_start >= audio_size) {
+                frame_start -= audio_size;
+            }
+            loadFrame(audio, audio_size, frame_start, workspace->fft_buffer);
+            computeFrame(backend, workspace, suppressor);
+
+            for (int mel = 0; mel < NUM_MELS; mel++) {
+                float v = workspace->mel_energies[mel];
+                spectrogram[mel * NUM_FRAMES + frame] = v;
+                max_val = v > max_val ? v : max_val;
+            }
+        }
+        return max_val;
+    }
+
+    // Ненормализованная спектрограмма всего окна. Возвращает максимум
+    static float computeSpectrogram(const FrontendBackend* backend, const int16_t* audio, int audio_size,
+                                    int start, float* spectrogram, Workspace* workspace,
+                                    const MelNoiseSuppressor* suppressor = nullptr) {
+        return computeFrames(backend, audio, audio_size, start, spectrogram, workspace, 0, NUM_FRAMES,
+                             suppressor);
+    }
+};
+
+#endif // MEL_FRONTEND_H
@@ -0,0 +1,83 @@
+#include "mel_stream.h"
+#include "audio_capture.h"
+#include "memory_plan.h"
+#include <string.h>
+
+// Шагов с последнего сброса и кадров в кольце (слот = номер кадра % NUM_FRAMES)
+static int s_hops_since_reset = 0;
+static uint32_t s_frame_count = 0;
+static PcenState s_pcen;
+static int s_idle_hops = 0;            // шагов простоя с последнего сброса
+
+void melStreamReset() {
+    s_hops_since_reset = 0;
+    s_idle_hops = 0;
+    s_frame_count = 0;
+    pcenReset(&s_pcen);
+}
+
+const float* melStreamPushHop(FrontendWorkspace* workspace) {
+    if (++s_hops_since_reset < MEL_STREAM_WARMUP_HOPS) {
+        return nullptr;
+    }
+
+    loadFrame(captureRing(), CAPTURE_RING_SIZE, captureTailStart(FFT_SIZE), workspace->fft_buffer);
+    computeStreamMelFrame(workspace);
+
+    int index = s_frame_count % NUM_FRAMES;
+    float* slot = g_pipeline_arena.mel_frames + index * NUM_FEATURES;
+    if (FRAME_FEATURES_FINAL) {
+        frameFeatures(&s_pcen, workspace->mel_energies, slot);
+    } else {
+        memcpy(slot, workspace->mel_energies, NUM_MELS * sizeof(float));
+    }
+    s_frame_count++;
+    return workspace->mel_energies;
+}
+
+void melStreamIdleHop(FrontendWorkspace* workspace) {
+    if (!MEL_NOISE_SUPPRESSION) {
+        return;
+    }
+    int hop = s_idle_hops++;
+    if (hop < MEL_STREAM_WARMUP_HOPS || (hop - MEL_STREAM_WARMUP_HOPS) % MEL_NOISE_IDLE_STRIDE != 0) {
+        return;
+    }
+    loadFrame(captureRing(), CAPTURE_RING_SIZE, captureTailStart(FFT_SIZE), workspace->fft_buffer);
+    updateMelNoise(workspace);
+}
+
+void melStreamLastFrame(float* frame) {
+    int last = (s_frame_count + NUM_FRAMES - 1) % NUM_FRAMES;
+    memcpy(frame, g_pipeline_arena.mel_frames + last * NUM_FEATURES, NUM_FEATURES * sizeof(float));
+}
+
+bool melStreamWindowReady() {
+    return s_frame_count >= (uint32_t)NUM_FRAMES;
+}
+
+void melStreamToSpectrogram(float* spectrogram, FloatStats* stats) {
+    // Самый старый кадр окна лежит в слоте следующей записи
+    int oldest = s_frame_count % NUM_FRAMES;
+    float max_val = 0;
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        int slot = oldest + frame;
+        if (slot >= NUM_FRAMES) {
+            slot -= NUM_FRAMES;
+        }
+        const float* features = g_pipeline_arena.mel_frames + slot * NUM_FEATURES;
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            float v = features[i];
+            spectrogram[i * NUM_FRAMES + frame] = v;
+            max_val = v > max_val ? v : max_val;
+        }
+    }
+
+    if (!FRAME_FEATURES_FINAL) {
+        normalizeSpectrogram(spectrogram, SPECTROGRAM_SIZE, max_val, stats);
+    } else if (stats != nullptr) {
+        resetStats(stats);
+        accumulateStats(spectrogram, SPECTROGRAM_SIZE, SPECTROGRAM_SIGNIFICANT_LEVEL, stats);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef MEL_STREAM_H
+#define MEL_STREAM_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "audio_processing.h"
+
+// Потоковый фронтенд: на каждом шаге захвата считается один новый кадр -
+// последние FFT_SIZE отсчетов кольца захвата - и кладется в кольцо
+// мель-кадров (memory_plan.h). Спектрограмма окна собирается из кольца
+// без пересчета FFT и совпадает с audioToMelSpectrogram по тем же отсчетам.
+// После разрыва потока (ошибка I2S, пропущенные шаги) кольцо сбрасывается.
+// При FRAME_FEATURES_FINAL (PCEN или MFCC) в кольцо кладутся готовые
+// признаки кадра (NUM_FEATURES; состояние PCEN идет вместе с потоком и
+// сбрасывается с ним), и окно собирается без второго прохода нормализации
+
+// Шагов после сброса до первого кадра, целиком состоящего из новых отсчетов
+const int MEL_STREAM_WARMUP_HOPS = (FFT_SIZE + HOP_LENGTH - 1) / HOP_LENGTH;
+
+void melStreamReset();
+
+// Кадр по только что захваченному шагу. Возвращает мель-энергии кадра
+// (ненормализованные, в workspace) или nullptr, пока поток прогревается после сброса
+const float* melStreamPushHop(FrontendWorkspace* workspace);
+
+// Шаг захвата, пока поток кадров стоит (простой банка Герцеля): кадр не
+// выдается, но при MEL_NOISE_SUPPRESSION оценка шума продолжает следовать
+// за фоном (раз в MEL_NOISE_IDLE_STRIDE шагов), и первое окно после
+// срабатывания вычитает актуальный шум
+void melStreamIdleHop(FrontendWorkspace* workspace);
+
+// Последний кадр кольца, NUM_FEATURES значений. Вход потоковой модели только
+// при FRAME_FEATURES_FINAL: это и есть столбец окна. При WINDOW_MAX кадр в
+// кольце не нормализован, а в окне его делит максимум всего окна, который
+// меняется, пока кадр в нем, - отдельно взятый кадр в этот масштаб не привести
+void melStreamLastFrame(float* frame);
+
+// В кольце NUM_FRAMES последовательных кадров - окно можно собрать из кольца
+bool melStreamWindowReady();
+
+// Сборка спектрограммы окна из последних NUM_FRAMES кадров с нормализацией
+// (готовые признаки кадров не нормализуются повторно)
+void melStreamToSpectrogram(float* spectrogram, FloatStats* stats = nullptr);
+
+#endif // MEL_STREAM_H
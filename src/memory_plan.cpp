@@ -0,0 +1,45 @@
+#include "memory_plan.h"
+#ifdef ARDUINO
+#include "diagnostics.h"
+#include <esp_heap_caps.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Внутренняя DRAM, доступная DMA; кольцо выровнено по строке кэша
+DMA_ATTR PipelineArena g_pipeline_arena;
+#else
+PipelineArena g_pipeline_arena;
+#endif
+
+#ifdef ARDUINO
+void reportMemoryPlan() {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== ПЛАН ПАМЯТИ ===");
+    Serial.print("Арена конвейера: "); Serial.print(sizeof(PipelineArena)); Serial.println(" байт");
+    Serial.print("  кольцо захвата: "); Serial.println(sizeof(g_pipeline_arena.capture_ring));
+#ifdef CAPTURE_SAMPLE_RATE
+    Serial.print("  сырой шаг I2S: "); Serial.println(sizeof(g_pipeline_arena.capture_raw));
+#endif
+    Serial.print("  рабочая область фронтенда: "); Serial.println(sizeof(g_pipeline_arena.workspace));
+    Serial.print("  рабочая область ядра 0: "); Serial.println(sizeof(g_pipeline_arena.worker_workspace));
+    Serial.print("  кольцо мель-кадров: "); Serial.println(sizeof(g_pipeline_arena.mel_frames));
+    Serial.print("  спектрограмма: "); Serial.println(sizeof(g_pipeline_arena.spectrogram));
+#ifdef CAPTURE_SAMPLE_RATE
+    Serial.print("Коэффициенты ресемплера (вне арены): ");
+    Serial.println(sizeof(int16_t) * CAPTURE_RESAMPLER_TABLE_SIZE);
+#endif
+    Serial.print("DMA-буферы I2S (драйвер): "); Serial.print(CAPTURE_DMA_BYTES);
+    Serial.print(" байт, запас "); Serial.print(CAPTURE_SLACK_MS); Serial.println(" мс");
+    Serial.print("Внутренняя RAM свободно: ");
+    Serial.print(heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    Serial.print(" (минимум: ");
+    Serial.print(heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+    Serial.println(")");
+    // На ESP-IDF запас стека возвращается в байтах
+    UBaseType_t stack_free = uxTaskGetStackHighWaterMark(NULL);
+    Serial.print("Стек задачи: использовано максимум ");
+    Serial.print(CONFIG_ARDUINO_LOOP_STACK_SIZE - stack_free);
+    Serial.print(" из "); Serial.println(CONFIG_ARDUINO_LOOP_STACK_SIZE);
+#endif
+}
+#endif
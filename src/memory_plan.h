@@ -0,0 +1,53 @@
+#ifndef MEMORY_PLAN_H
+#define MEMORY_PLAN_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "audio_processing.h"
+#include "audio_capture.h"
+
+// Единый статический план памяти конвейера. Время жизни буферов:
+//
+//   фаза             | capture_ring | capture_raw | workspace | worker_workspace | mel_frames | spectrogram
+//   i2s_read (шаг)   |      W       |     RW      |           |                  |            |
+//   кадр шага        |      R       |             |    RW     |                  |     W      |
+//   сборка окна      |              |             |           |                  |     R      |      W
+//   полный пересчет  |      R       |             |    RW     |        RW        |            |      W
+//   вход модели      |              |             |           |                  |            |      R
+//
+// Общей памяти у буферов нет - ни одна пара не может ее делить:
+// - кольцо захвата, кольцо мель-кадров и сырой шаг I2S (остаток
+//   переходит в следующий шаг) живут постоянно;
+// - спектрограмма свободна между окнами, но тогда на каждом шаге занята
+//   рабочая область фронтенда; вторая рабочая область свободна почти всегда,
+//   но нужна при полном пересчете - одновременно с первой и со спектрограммой,
+//   которую этот пересчет и пишет.
+// Исходные копии окна (int16 и float, BUFFER_SIZE) не нужны вовсе: фронтенд
+// читает кадры прямо из кольца захвата, преобразуя int16 -> float при загрузке.
+// Вторая рабочая область принадлежит задаче на ядре 0 (frontend_parallel.h).
+// Тензорная арена модели (kTensorArenaSize) остается в PSRAM и сюда не входит.
+struct PipelineArena {
+    alignas(CAPTURE_BUFFER_ALIGN) int16_t capture_ring[CAPTURE_RING_SIZE];
+#ifdef CAPTURE_SAMPLE_RATE
+    // Сырой шаг I2S до ресемплера (audio_capture.h). Коэффициенты ресемплера
+    // к DMA не относятся и лежат вне арены (audio_capture.cpp)
+    alignas(CAPTURE_BUFFER_ALIGN) int16_t capture_raw[CAPTURE_HOP_SAMPLES];
+#endif
+    FrontendWorkspace workspace;
+    FrontendWorkspace worker_workspace;
+    float mel_frames[NUM_FRAMES * NUM_FEATURES];
+    float spectrogram[MEL_SPECTROGRAM_SIZE];
+};
+
+static_assert(CAPTURE_RING_SIZE >= WINDOW_SAMPLES, "кольцо захвата должно вмещать окно");
+static_assert(CAPTURE_RING_SIZE % HOP_LENGTH == 0, "кольцо захвата - целое число шагов");
+
+extern PipelineArena g_pipeline_arena;
+
+#ifdef ARDUINO
+// Вывод размеров плана, свободной внутренней RAM и минимального запаса стека задачи
+void reportMemoryPlan();
+#endif
+
+#endif // MEMORY_PLAN_H
@@ -0,0 +1,345 @@
+#include "model_hot_swap.h"
+#include "alloc_tracker.h"
+#include "diagnostics.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const slot_labels[2] = {MODEL_PARTITION_LABEL, MODEL_STANDBY_PARTITION_LABEL};
+static TaskHandle_t swap_task = nullptr;
+static TaskHandle_t write_task = nullptr;
+
+// Сектор заголовка ждет конца приема, остальные пишутся по мере прихода
+static uint8_t s_header_sector[MODEL_WRITE_SECTOR_SIZE];
+static uint8_t s_write_sector[MODEL_WRITE_SECTOR_SIZE];
+
+// Состояние передается между ядрами с барьерами acquire/release:
+// поля менеджера, записанные до смены состояния, видны другой задаче
+static int loadState(const ModelHotSwap* swap) {
+    return __atomic_load_n(&swap->state, __ATOMIC_ACQUIRE);
+}
+
+static void storeState(ModelHotSwap* swap, int state) {
+    __atomic_store_n(&swap->state, state, __ATOMIC_RELEASE);
+}
+
+// Переход только из MODEL_SWAP_IDLE: задача замены и задача приема не
+// занимают резервный раздел одновременно
+static bool claimIdle(ModelHotSwap* swap, int state) {
+    int expected = MODEL_SWAP_IDLE;
+    return __atomic_compare_exchange_n(&swap->state, &expected, state, false, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+}
+
+// Образ снимается с менеджера, отображение раздела остается
+static void releaseImage(MappedModel* image) {
+    image->header = nullptr;
+    image->model_data = nullptr;
+}
+
+// Образ раздела slot в менеджер slot: проверка на месте, резолверы, AllocateTensors()
+static bool prepareSlot(ModelHotSwap* swap, int slot) {
+    MappedModel* image = &swap->images[slot];
+    if (!modelImageValidate((const uint8_t*)image->map_base, image->map_size, image)) {
+        return false;
+    }
+    ModelManager* manager = &swap->managers[slot];
+    modelManagerBegin(manager, swap->arenas[slot], swap->arena_size, swap->error_reporter);
+    int general = modelManagerAdd(manager, "general", image->model_data);
+    int specialist = swap->specialist != nullptr ? modelManagerAdd(manager, "specialist", swap->specialist) : -1;
+    if (general < 0 || modelManagerActivate(manager, general) == nullptr) {
+        releaseImage(image);
+        return false;
+    }
+    swap->general = general;
+    swap->specialist_index = specialist;
+    return true;
+}
+
+static void retireSlot(ModelHotSwap* swap, int slot) {
+    modelManagerEnd(&swap->managers[slot]);
+    releaseImage(&swap->images[slot]);
+}
+
+static void modelSwapTask(void* arg) {
+    ModelHotSwap* swap = (ModelHotSwap*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MODEL_SWAP_CHECK_MS));
+        int state = loadState(swap);
+        if (state == MODEL_SWAP_RETIRING) {
+            retireSlot(swap, 1 - swap->active);
+            storeState(swap, MODEL_SWAP_IDLE);
+            continue;
+        }
+        if (state != MODEL_SWAP_IDLE) {
+            continue;
+        }
+
+        // Дешевая проверка: только заголовок резервного раздела
+        int standby = 1 - swap->active;
+        uint32_t version = 0;
+        uint32_t header_crc = 0;
+        uint32_t active_version = swap->images[swap->active].header->model_version;
+        if (!modelPartitionVersion(swap->partitions[standby], &version, &header_crc) || version <= active_version ||
+            (version == swap->rejected_version && header_crc == swap->rejected_header_crc)) {
+            continue;
+        }
+
+        if (!claimIdle(swap, MODEL_SWAP_PREPARING)) {
+            continue;
+        }
+        swap->windows_during_prepare = 0;
+        swap->overruns_during_prepare = 0;
+        uint32_t start = micros();
+        stackBudgetBegin();
+        bool prepared = prepareSlot(swap, standby);
+        stackBudgetEnd();
+        if (!prepared) {
+            swap->rejected_version = version;
+            swap->rejected_header_crc = header_crc;
+            storeState(swap, MODEL_SWAP_IDLE);
+            continue;
+        }
+        swap->prepare_us = micros() - start;
+        storeState(swap, MODEL_SWAP_READY);
+    }
+}
+
+// Ответ протокола записи одной операцией записи в порт: строки не
+// перемешиваются с отладочным выводом loop()
+static void writeReply(const char* status, const char* detail = nullptr) {
+    char line[48] = "MODEL_WRITE ";
+    strncat(line, status, sizeof(line) - strlen(line) - 3);
+    if (detail != nullptr) {
+        strncat(line, " ", sizeof(line) - strlen(line) - 3);
+        strncat(line, detail, sizeof(line) - strlen(line) - 3);
+    }
+    strcat(line, "\r\n");
+    Serial.write((const uint8_t*)line, strlen(line));
+}
+
+// Ровно size байт из порта. timeout_ms = 0 - ждать бесконечно. Ожидание -
+// vTaskDelay, а не опрос в цикле: на ядре 0 работает задача простоя
+static bool readExact(uint8_t* buffer, size_t size, uint32_t timeout_ms) {
+    size_t received = 0;
+    uint32_t last = millis();
+    while (received < size) {
+        int available = Serial.available();
+        if (available <= 0) {
+            if (timeout_ms != 0 && millis() - last > timeout_ms) {
+                return false;
+            }
+            vTaskDelay(pdMS_TO_TICKS(MODEL_WRITE_POLL_MS));
+            continue;
+        }
+        size_t chunk = size - received < (size_t)available ? size - received : (size_t)available;
+        received += Serial.read(buffer + received, chunk);
+        last = millis();
+    }
+    return true;
+}
+
+// Строка команды без '\n'; длинные строки обрезаются
+static void readLine(char* line, size_t capacity) {
+    size_t length = 0;
+    uint8_t c = 0;
+    while (readExact(&c, 1, 0) && c != '\n') {
+        if (c != '\r' && length + 1 < capacity) {
+            line[length++] = (char)c;
+        }
+    }
+    line[length] = '\0';
+}
+
+// Прием образа size байт в резервный раздел. nullptr - образ записан,
+// иначе причина отказа
+static const char* receiveImage(ModelHotSwap* swap, uint32_t size) {
+    const esp_partition_t* partition = swap->partitions[1 - swap->active];
+    if (size < (uint32_t)MODEL_IMAGE_DATA_OFFSET || size > partition->size) {
+        return "size";
+    }
+    // Прежний заголовок стирается первым: до конца приема раздел пуст
+    if (esp_partition_erase_range(partition, 0, MODEL_WRITE_SECTOR_SIZE) != ESP_OK) {
+        return "erase";
+    }
+    writeReply("OK", slot_labels[1 - swap->active]);
+
+    for (uint32_t offset = 0; offset < size; offset += MODEL_WRITE_SECTOR_SIZE) {
+        uint32_t length = size - offset < MODEL_WRITE_SECTOR_SIZE ? size - offset : MODEL_WRITE_SECTOR_SIZE;
+        uint8_t* sector = offset == 0 ? s_header_sector : s_write_sector;
+        if (!readExact(sector, length, MODEL_WRITE_TIMEOUT_MS)) {
+            return "timeout";
+        }
+        if (offset != 0 && (esp_partition_erase_range(partition, offset, MODEL_WRITE_SECTOR_SIZE) != ESP_OK ||
+                            esp_partition_write(partition, offset, sector, length) != ESP_OK)) {
+            return "write";
+        }
+        if (offset + length < size) {
+            writeReply("OK");
+        }
+    }
+    uint32_t header_length = size < MODEL_WRITE_SECTOR_SIZE ? size : MODEL_WRITE_SECTOR_SIZE;
+    if (esp_partition_write(partition, 0, s_header_sector, header_length) != ESP_OK) {
+        return "write";
+    }
+    return nullptr;
+}
+
+static void modelWriteTask(void* arg) {
+    ModelHotSwap* swap = (ModelHotSwap*)arg;
+    const char command[] = "MODEL_WRITE ";
+    char line[48];
+    for (;;) {
+        readLine(line, sizeof(line));
+        if (strncmp(line, command, sizeof(command) - 1) != 0) {
+            continue;
+        }
+        uint32_t size = strtoul(line + sizeof(command) - 1, nullptr, 10);
+        // Пока готовится или меняется модель, резервный раздел занят
+        if (!claimIdle(swap, MODEL_SWAP_WRITING)) {
+            writeReply("ERR", "busy");
+            continue;
+        }
+        swap->windows_during_write = 0;
+        swap->overruns_during_write = 0;
+        uint32_t start = millis();
+        stackBudgetBegin();
+        const char* error = receiveImage(swap, size);
+        stackBudgetEnd();
+        storeState(swap, MODEL_SWAP_IDLE);
+        if (error != nullptr) {
+            writeReply("ERR", error);
+            continue;
+        }
+        swap->writes++;
+        swap->write_ms = millis() - start;
+        writeReply("DONE");
+        // Новый образ проверяется сразу, без ожидания MODEL_SWAP_CHECK_MS
+        if (swap_task != nullptr) {
+            xTaskNotifyGive(swap_task);
+        }
+    }
+}
+
+bool modelHotSwapBegin(ModelHotSwap* swap, uint8_t* arena, uint8_t* standby_arena, size_t arena_size,
+                       tflite::ErrorReporter* error_reporter, const void* specialist) {
+    swap->arenas[0] = arena;
+    swap->arenas[1] = standby_arena;
+    swap->arena_size = arena_size;
+    swap->images[0] = MappedModel();
+    swap->images[1] = MappedModel();
+    swap->specialist = specialist;
+    swap->error_reporter = error_reporter;
+    swap->state = MODEL_SWAP_IDLE;
+    swap->rejected_version = 0;
+    swap->rejected_header_crc = 0;
+    swap->swaps = 0;
+    swap->prepare_us = 0;
+    swap->switch_us = 0;
+    swap->windows_during_prepare = 0;
+    swap->overruns_during_prepare = 0;
+    swap->writes = 0;
+    swap->write_ms = 0;
+    swap->windows_during_write = 0;
+    swap->overruns_during_write = 0;
+
+    // Оба раздела отображаются один раз и навсегда
+    for (int slot = 0; slot < 2; slot++) {
+        swap->partitions[slot] = modelPartitionFind(slot_labels[slot]);
+        if (!modelPartitionMapAll(swap->partitions[slot], &swap->images[slot])) {
+            return false;
+        }
+    }
+
+    // Сначала раздел с более новой версией, при ошибке - второй
+    uint32_t versions[2] = {0, 0};
+    uint32_t header_crcs[2] = {0, 0};
+    bool present[2];
+    for (int slot = 0; slot < 2; slot++) {
+        present[slot] = modelPartitionVersion(swap->partitions[slot], &versions[slot], &header_crcs[slot]);
+    }
+    swap->active = present[1] && (!present[0] || versions[1] > versions[0]) ? 1 : 0;
+    if (!prepareSlot(swap, swap->active)) {
+        swap->active = 1 - swap->active;
+        if (!present[swap->active] || !prepareSlot(swap, swap->active)) {
+            return false;
+        }
+    }
+    // Отвергнутый при загрузке образ не проверяется повторно
+    if (present[1 - swap->active] && versions[1 - swap->active] > versions[swap->active]) {
+        swap->rejected_version = versions[1 - swap->active];
+        swap->rejected_header_crc = header_crcs[1 - swap->active];
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(modelSwapTask, "model_swap", MODEL_SWAP_STACK_SIZE, swap,
+                                                 MODEL_SWAP_PRIORITY, &swap_task, MODEL_SWAP_CORE);
+    if (created != pdPASS) {
+        swap_task = nullptr;
+        DIAG_ERRORLN("Фоновая задача замены модели не запущена");
+    } else {
+        stackBudgetRegisterTask(swap_task, MODEL_SWAP_STACK_SIZE, MODEL_SWAP_STACK_BUDGET);
+    }
+    created = xTaskCreatePinnedToCore(modelWriteTask, "model_write", MODEL_WRITE_STACK_SIZE, swap,
+                                      MODEL_SWAP_PRIORITY, &write_task, MODEL_SWAP_CORE);
+    if (created != pdPASS) {
+        write_task = nullptr;
+        DIAG_ERRORLN("Задача приема образа модели не запущена");
+    } else {
+        stackBudgetRegisterTask(write_task, MODEL_WRITE_STACK_SIZE, MODEL_WRITE_STACK_BUDGET);
+    }
+    return true;
+}
+
+ModelManager* modelHotSwapActive(ModelHotSwap* swap) {
+    return &swap->managers[swap->active];
+}
+
+const MappedModel& modelHotSwapImage(const ModelHotSwap& swap) {
+    return swap.images[swap.active];
+}
+
+ModelManager* modelHotSwapPoll(ModelHotSwap* swap) {
+    if (loadState(swap) == MODEL_SWAP_READY) {
+        uint32_t start = micros();
+        swap->active = 1 - swap->active;
+        swap->swaps++;
+        swap->switch_us = micros() - start;
+        storeState(swap, MODEL_SWAP_RETIRING);
+        xTaskNotifyGive(swap_task);
+    }
+    return &swap->managers[swap->active];
+}
+
+void modelHotSwapCountWindow(ModelHotSwap* swap, bool overrun) {
+    int state = loadState(swap);
+    if (state == MODEL_SWAP_PREPARING || state == MODEL_SWAP_READY) {
+        swap->windows_during_prepare++;
+        swap->overruns_during_prepare += overrun ? 1 : 0;
+    } else if (state == MODEL_SWAP_WRITING) {
+        swap->windows_during_write++;
+        swap->overruns_during_write += overrun ? 1 : 0;
+    }
+}
+
+void reportModelHotSwap(const ModelHotSwap& swap) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    const MappedModel& image = modelHotSwapImage(swap);
+    Serial.print("Модель: раздел "); Serial.print(slot_labels[swap.active]);
+    Serial.print(", версия "); Serial.println(image.header->model_version);
+    if (swap.writes != 0) {
+        Serial.print("Записей образа: "); Serial.print(swap.writes);
+        Serial.print(", последняя "); Serial.print(swap.write_ms); Serial.print(" мс, окон за запись: ");
+        Serial.print(swap.windows_during_write);
+        Serial.print(", из них с потерей шагов: "); Serial.println(swap.overruns_during_write);
+    }
+    if (swap.swaps == 0) {
+        return;
+    }
+    Serial.print("Замен модели: "); Serial.print(swap.swaps);
+    Serial.print(", подготовка в фоне "); Serial.print(swap.prepare_us / 1000);
+    Serial.print(" мс, смена "); Serial.print(swap.switch_us); Serial.println(" мкс");
+    Serial.print("Окон за подготовку: "); Serial.print(swap.windows_during_prepare);
+    Serial.print(", из них с потерей шагов: "); Serial.println(swap.overruns_during_prepare);
+#endif
+}
@@ -0,0 +1,109 @@
+#ifndef MODEL_HOT_SWAP_H
+#define MODEL_HOT_SWAP_H
+
+#include <Arduino.h>
+#include "model_manager.h"
+#include "model_image.h"
+
+// Замена модели без перезагрузки (сборка с -DMODEL_PARTITION -DMODEL_HOT_SWAP).
+// Два раздела образов ("model" и "model_b" в partitions.csv) и два менеджера
+// моделей, у каждого своя арена. Активен один; фоновая задача на ядре 0 раз
+// в MODEL_SWAP_CHECK_MS читает заголовок второго раздела и, если там образ
+// новее, отображает и проверяет его и размещает тензоры во второй арене, пока
+// loop() продолжает классифицировать. loop() между окнами забирает готовый
+// менеджер (modelHotSwapPoll - смена указателя), после чего фоновая задача
+// уничтожает прежний интерпретатор.
+// Куча в установившемся режиме не используется: оба раздела находятся и
+// отображаются целиком один раз в modelHotSwapBegin (поиск и отображение
+// раздела выделяют память), новый образ проверяется на месте в уже
+// отображенной памяти, арена прежнего менеджера остается резервной для
+// следующей замены.
+//
+// Запись образа без перезагрузки - задача приема на ядре 0: образ приходит
+// по USB Serial (tools/pack_model.py --send) и пишется в резервный раздел
+// (model_b, после замены - model). Протокол - строки с префиксом
+// "MODEL_WRITE" (отладочный вывод идет в тот же порт):
+//   хост: MODEL_WRITE <размер образа>   устройство: MODEL_WRITE OK <раздел>
+//   хост: сектор 4 КБ (последний - остаток) устройство: MODEL_WRITE OK,
+//         после последнего - MODEL_WRITE DONE; ошибка - MODEL_WRITE ERR <причина>
+// Сектор заголовка стирается первым, держится в RAM и пишется последним:
+// пока пишется модель, корректного заголовка в разделе нет, и фоновая
+// задача раздел не трогает. На время записи состояние - MODEL_SWAP_WRITING;
+// по окончании задача замены проверяет раздел сразу. Образ, не прошедший
+// проверку, запоминается по версии и CRC заголовка и повторно не проверяется.
+// Стирание и запись флеш-памяти на время операции с сектором останавливают
+// кэш обоих ядер: окна, обработанные за запись, и потери шагов считаются.
+// esptool.py write_flash перезагружает плату и годится только для первой
+// записи: раздел model - 0x670000, model_b - 0x730000 (partitions.csv)
+
+const char MODEL_STANDBY_PARTITION_LABEL[] = "model_b";
+const uint32_t MODEL_SWAP_CHECK_MS = 5000;
+const BaseType_t MODEL_SWAP_CORE = 0;
+const uint32_t MODEL_SWAP_STACK_SIZE = 6144;          // байт, AllocateTensors()
+const uint32_t MODEL_SWAP_STACK_BUDGET = 5120;        // байт на подготовку образа (alloc_tracker.h)
+const UBaseType_t MODEL_SWAP_PRIORITY = 1;            // ниже рабочих задач конвейера
+
+const uint32_t MODEL_WRITE_STACK_SIZE = 4096;         // байт, прием и запись во флеш
+const uint32_t MODEL_WRITE_STACK_BUDGET = 3072;
+const uint32_t MODEL_WRITE_SECTOR_SIZE = 4096;        // сектор стирания флеш-памяти
+const uint32_t MODEL_WRITE_TIMEOUT_MS = 3000;         // пауза хоста, после которой прием отменяется
+const uint32_t MODEL_WRITE_POLL_MS = 10;
+const size_t MODEL_WRITE_RX_BUFFER = MODEL_WRITE_SECTOR_SIZE + 256;  // приемный буфер USB Serial
+
+enum ModelSwapState {
+    MODEL_SWAP_IDLE,                                  // ожидание нового образа
+    MODEL_SWAP_PREPARING,                             // проверка образа и AllocateTensors() в фоне
+    MODEL_SWAP_READY,                                 // резервный менеджер готов к смене
+    MODEL_SWAP_RETIRING,                              // прежний менеджер освобождается
+    MODEL_SWAP_WRITING                                // прием образа в резервный раздел
+};
+
+struct ModelHotSwap {
+    ModelManager managers[2];                         // менеджер i - раздел i и арена i
+    uint8_t* arenas[2];
+    size_t arena_size;
+    const esp_partition_t* partitions[2];
+    MappedModel images[2];                            // разделы отображены целиком
+    const void* specialist;                           // встроенная специализированная модель или nullptr
+    tflite::ErrorReporter* error_reporter;
+    int active;
+    volatile int state;                               // ModelSwapState
+    int general;                                      // индексы моделей (одинаковы в обоих менеджерах)
+    int specialist_index;
+    uint32_t rejected_version;                        // образ, не прошедший проверку:
+    uint32_t rejected_header_crc;                     // версия и CRC заголовка
+    // Замер последней замены
+    uint32_t swaps;
+    uint32_t prepare_us;                              // подготовка в фоне
+    uint32_t switch_us;                               // смена в loop()
+    uint32_t windows_during_prepare;                  // окон, обработанных старой моделью за подготовку
+    uint32_t overruns_during_prepare;                 // из них с потерей шагов захвата
+    // Замер последней записи образа
+    uint32_t writes;
+    uint32_t write_ms;
+    uint32_t windows_during_write;
+    uint32_t overruns_during_write;
+};
+
+// Активная модель - из раздела с самой новой корректной версией, затем
+// запуск фоновой задачи и задачи приема образа. Обе арены выделяются заранее
+// вызывающей стороной; USB Serial запускается до вызова (приемный буфер -
+// не меньше MODEL_WRITE_RX_BUFFER)
+bool modelHotSwapBegin(ModelHotSwap* swap, uint8_t* arena, uint8_t* standby_arena, size_t arena_size,
+                       tflite::ErrorReporter* error_reporter, const void* specialist);
+
+ModelManager* modelHotSwapActive(ModelHotSwap* swap);
+const MappedModel& modelHotSwapImage(const ModelHotSwap& swap);
+
+// Вызывается между окнами: если резервный менеджер готов, он становится
+// активным. Возвращает активный менеджер
+ModelManager* modelHotSwapPoll(ModelHotSwap* swap);
+
+// Учет окна, обработанного во время записи образа или подготовки замены
+// (overrun - окно обрабатывалось дольше запаса DMA и часть шагов потеряна)
+void modelHotSwapCountWindow(ModelHotSwap* swap, bool overrun);
+
+// Версия активной модели, замеры последней записи и последней замены
+void reportModelHotSwap(const ModelHotSwap& swap);
+
+#endif // MODEL_HOT_SWAP_H
@@ -0,0 +1,249 @@
+#include "model_image.h"
+#include <string.h>
+#ifdef ARDUINO
+#include "diagnostics.h"
+#else
+#include <stdio.h>
+#include <time.h>
+#endif
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ARDUINO
+// Все операции образа регистрируются в резолвере менеджера
+static_assert(MODEL_IMAGE_MAX_OPS <= MODEL_MAX_OPS, "Образ перечисляет больше операций, чем вмещает резолвер");
+#endif
+
+static void imageError(const char* message) {
+#ifdef ARDUINO
+    DIAG_ERRORLN(message);
+#else
+    fprintf(stderr, "%s\n", message);
+#endif
+}
+
+static uint32_t imageMicros() {
+#ifdef ARDUINO
+    return micros();
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000ull + now.tv_nsec / 1000);
+#endif
+}
+
+// CRC-32 (zlib): на устройстве - из ROM, на хосте - побитово
+static uint32_t imageCrc32(const uint8_t* data, size_t size) {
+#ifdef ESP_PLATFORM
+    return esp_rom_crc32_le(0, data, size);
+#else
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+#endif
+}
+
+// Операции модели - ровно те, что перечислены в заголовке
+static bool opsMatchHeader(const tflite::Model* model, const ModelImageHeader* header) {
+    const auto* op_codes = model->operator_codes();
+    if (op_codes == nullptr) {
+        return false;
+    }
+    int distinct = 0;
+    for (unsigned i = 0; i < op_codes->size(); i++) {
+        int op = tflite::GetBuiltinCode(op_codes->Get(i));
+        bool listed = false;
+        for (int j = 0; j < header->num_ops; j++) {
+            listed = listed || header->ops[j] == op;
+        }
+        if (!listed) {
+            return false;
+        }
+        bool repeated = false;
+        for (unsigned j = 0; j < i; j++) {
+            repeated = repeated || tflite::GetBuiltinCode(op_codes->Get(j)) == op;
+        }
+        distinct += repeated ? 0 : 1;
+    }
+    return distinct == header->num_ops;
+}
+
+bool modelImageValidate(const uint8_t* image, size_t image_size, MappedModel* mapped) {
+    uint32_t start = imageMicros();
+    const ModelImageHeader* header = (const ModelImageHeader*)image;
+    if (image_size < (size_t)MODEL_IMAGE_DATA_OFFSET || header->magic != MODEL_IMAGE_MAGIC) {
+        imageError("Образ модели не найден");
+        return false;
+    }
+    if (header->format != MODEL_IMAGE_FORMAT ||
+        imageCrc32(image, offsetof(ModelImageHeader, header_crc)) != header->header_crc) {
+        imageError("Заголовок образа модели поврежден или другого формата");
+        return false;
+    }
+    if (header->num_ops > MODEL_IMAGE_MAX_OPS || header->model_size > image_size - MODEL_IMAGE_DATA_OFFSET) {
+        imageError("Образ модели не помещается в раздел");
+        return false;
+    }
+
+    // CRC считается по отображенной памяти: веса читаются через кэш, не копируются
+    const uint8_t* model_data = image + MODEL_IMAGE_DATA_OFFSET;
+    if (imageCrc32(model_data, header->model_size) != header->model_crc) {
+        imageError("Контрольная сумма модели не совпадает");
+        return false;
+    }
+    const tflite::Model* model = tflite::GetModel(model_data);
+    if (model == nullptr || model->version() != TFLITE_SCHEMA_VERSION) {
+        imageError("Несовместимая версия схемы модели в образе");
+        return false;
+    }
+    if (!opsMatchHeader(model, header)) {
+        imageError("Список операций в заголовке не совпадает с моделью");
+        return false;
+    }
+
+    mapped->header = header;
+    mapped->model_data = model_data;
+    mapped->validate_us = imageMicros() - start;
+    return true;
+}
+
+#ifdef ESP_PLATFORM
+const esp_partition_t* modelPartitionFind(const char* label) {
+    const esp_partition_t* partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) {
+        DIAG_ERROR("Раздел модели не найден: ");
+        DIAG_ERRORLN(label);
+    }
+    return partition;
+}
+
+static bool mapPartition(const esp_partition_t* partition, size_t map_size, MappedModel* mapped) {
+    const void* base = nullptr;
+    spi_flash_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, map_size, ESP_PARTITION_MMAP_DATA, &base, &handle) != ESP_OK) {
+        DIAG_ERRORLN("Ошибка отображения раздела модели");
+        return false;
+    }
+    mapped->map_base = base;
+    mapped->map_size = map_size;
+    mapped->map_handle = handle;
+    return true;
+}
+
+bool modelPartitionMap(const esp_partition_t* partition, MappedModel* mapped) {
+    if (partition == nullptr) {
+        return false;
+    }
+
+    // Отображается только сам образ, а не весь раздел: размер - из заголовка
+    ModelImageHeader header;
+    if (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    size_t map_size = partition->size;
+    if (header.magic == MODEL_IMAGE_MAGIC && header.model_size <= partition->size - MODEL_IMAGE_DATA_OFFSET) {
+        map_size = MODEL_IMAGE_DATA_OFFSET + header.model_size;
+    }
+
+    if (!mapPartition(partition, map_size, mapped)) {
+        return false;
+    }
+    if (!modelImageValidate((const uint8_t*)mapped->map_base, map_size, mapped)) {
+        modelImageUnmap(mapped);
+        return false;
+    }
+    return true;
+}
+
+bool modelPartitionMapAll(const esp_partition_t* partition, MappedModel* mapped) {
+    return partition != nullptr && mapPartition(partition, partition->size, mapped);
+}
+
+bool modelPartitionVersion(const esp_partition_t* partition, uint32_t* version, uint32_t* header_crc) {
+    ModelImageHeader header;
+    if (partition == nullptr || esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    if (header.magic != MODEL_IMAGE_MAGIC || header.format != MODEL_IMAGE_FORMAT ||
+        imageCrc32((const uint8_t*)&header, offsetof(ModelImageHeader, header_crc)) != header.header_crc) {
+        return false;
+    }
+    *version = header.model_version;
+    if (header_crc != nullptr) {
+        *header_crc = header.header_crc;
+    }
+    return true;
+}
+#else
+bool modelFileMap(const char* path, MappedModel* mapped) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    mapped->map_base = base;
+    mapped->map_size = st.st_size;
+    mapped->map_handle = 0;
+    if (!modelImageValidate((const uint8_t*)base, st.st_size, mapped)) {
+        modelImageUnmap(mapped);
+        return false;
+    }
+    return true;
+}
+#endif
+
+void modelImageUnmap(MappedModel* mapped) {
+    if (mapped->map_base != nullptr) {
+#ifdef ESP_PLATFORM
+        spi_flash_munmap(mapped->map_handle);
+#else
+        munmap((void*)mapped->map_base, mapped->map_size);
+#endif
+    }
+    mapped->map_base = nullptr;
+    mapped->map_size = 0;
+    mapped->header = nullptr;
+    mapped->model_data = nullptr;
+}
+
+#ifdef ARDUINO
+void reportModelImage(const MappedModel& mapped) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== ОБРАЗ МОДЕЛИ ===");
+    if (mapped.header == nullptr) {
+        Serial.println("Образ не загружен");
+        return;
+    }
+    Serial.print("Версия модели: "); Serial.println(mapped.header->model_version);
+    Serial.print("Размер: "); Serial.print(mapped.header->model_size);
+    Serial.print(" байт по адресу 0x"); Serial.println((uint32_t)(uintptr_t)mapped.model_data, HEX);
+    Serial.print("Операции:");
+    for (int i = 0; i < mapped.header->num_ops; i++) {
+        Serial.print(" "); Serial.print(mapped.header->ops[i]);
+    }
+    Serial.println();
+    Serial.print("Проверка заголовка и CRC: "); Serial.print(mapped.validate_us); Serial.println(" мкс");
+#endif
+}
+#endif // ARDUINO
@@ -0,0 +1,93 @@
+#ifndef MODEL_IMAGE_H
+#define MODEL_IMAGE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "model_manager.h"
+#else
+// На хосте - дублер схемы из нативного теста (test/tflite_reference)
+#include <stdint.h>
+#include <stddef.h>
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+#endif
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#endif
+
+// Образ модели во флеш-разделе данных (сборка с -DMODEL_PARTITION, раздел
+// "model" в partitions.csv, образ собирает tools/pack_model.py и пишет esptool).
+// Раздел отображается в адресное пространство через MMU (esp_partition_mmap):
+// flatbuffer читается интерпретатором прямо из флеш-памяти через кэш, веса
+// в RAM не копируются, смена модели не требует пересборки прошивки.
+// На хосте тот же образ отображается из файла через mmap.
+// Раскладка образа:
+//   0                        - ModelImageHeader
+//   MODEL_IMAGE_DATA_OFFSET  - flatbuffer модели (.tflite), model_size байт
+
+const uint32_t MODEL_IMAGE_MAGIC = 0x4C444D53;  // "SMDL"
+const uint16_t MODEL_IMAGE_FORMAT = 1;
+const int MODEL_IMAGE_DATA_OFFSET = 128;        // кратно 16 - выравнивание flatbuffer для TFLM
+const char MODEL_PARTITION_LABEL[] = "model";
+const int MODEL_IMAGE_MAX_OPS = 16;             // MODEL_MAX_OPS в tools/pack_model.py
+
+// Все поля little-endian, CRC-32 - как у zlib
+struct ModelImageHeader {
+    uint32_t magic;
+    uint16_t format;
+    uint16_t num_ops;
+    uint32_t model_version;                      // версия модели, растет с каждым выпуском
+    uint32_t model_size;                         // байт flatbuffer
+    uint32_t model_crc;                          // CRC-32 flatbuffer
+    int32_t ops[MODEL_IMAGE_MAX_OPS];            // коды встроенных операций модели
+    uint32_t header_crc;                         // CRC-32 предыдущих полей заголовка
+};
+
+static_assert(sizeof(ModelImageHeader) <= MODEL_IMAGE_DATA_OFFSET, "Заголовок перекрывает модель");
+
+struct MappedModel {
+    const ModelImageHeader* header;
+    const uint8_t* model_data;                   // flatbuffer в отображенной памяти
+    uint32_t validate_us;                        // проверка заголовка и CRC модели
+    const void* map_base;                        // отображение целиком (для снятия)
+    size_t map_size;
+    uint32_t map_handle;                         // дескриптор отображения раздела
+};
+
+// Проверка образа по адресу image: заголовок, его CRC, размер, CRC модели,
+// версия схемы и совпадение списка операций с operator_codes() модели.
+// Данные только читаются на месте. CRC по весам считается при каждой проверке:
+// CRC заголовка покрывает только заголовок
+bool modelImageValidate(const uint8_t* image, size_t image_size, MappedModel* mapped);
+
+#ifdef ESP_PLATFORM
+// Раздел образа по метке или nullptr. Поиск выделяет итератор в куче -
+// только при запуске, в установившемся режиме используется найденный раздел
+const esp_partition_t* modelPartitionFind(const char* label);
+
+// Отображение образа раздела (по размеру из заголовка) и проверка.
+// false - раздела нет или образ поврежден
+bool modelPartitionMap(const esp_partition_t* partition, MappedModel* mapped);
+
+// Отображение всего раздела без проверки: образ в нем может смениться,
+// проверка - modelImageValidate по map_base (model_hot_swap.h). Запись в
+// раздел через esp_partition_* сбрасывает кэш отображения
+bool modelPartitionMapAll(const esp_partition_t* partition, MappedModel* mapped);
+
+// Версия образа в разделе по одному заголовку (с проверкой его CRC),
+// без отображения и проверки самой модели. header_crc - CRC заголовка
+// (отличает образы одной версии), может быть nullptr. Куча не используется
+bool modelPartitionVersion(const esp_partition_t* partition, uint32_t* version, uint32_t* header_crc = nullptr);
+#else
+// Отображение файла образа и проверка
+bool modelFileMap(const char* path, MappedModel* mapped);
+#endif
+
+void modelImageUnmap(MappedModel* mapped);
+
+#ifdef ARDUINO
+// Версия, размер, операции модели и время проверки при загрузке
+void reportModelImage(const MappedModel& mapped);
+#endif
+
+#endif // MODEL_IMAGE_H
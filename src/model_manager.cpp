@@ -0,0 +1,215 @@
+#include "model_manager.h"
+#include "diagnostics.h"
+#include <new>
+#include <string.h>
+
+// Регистрация одной встроенной операции в резолвере
+static TfLiteStatus addBuiltinOp(ModelOpResolver* resolver, tflite::BuiltinOperator op) {
+    switch (op) {
+        case tflite::BuiltinOperator_ADD:               return resolver->AddAdd();
+        case tflite::BuiltinOperator_AVERAGE_POOL_2D:   return resolver->AddAveragePool2D();
+        case tflite::BuiltinOperator_CONCATENATION:     return resolver->AddConcatenation();
+        case tflite::BuiltinOperator_CONV_2D:           return resolver->AddConv2D();
+        case tflite::BuiltinOperator_DEPTHWISE_CONV_2D: return resolver->AddDepthwiseConv2D();
+        case tflite::BuiltinOperator_DEQUANTIZE:        return resolver->AddDequantize();
+        case tflite::BuiltinOperator_FULLY_CONNECTED:   return resolver->AddFullyConnected();
+        case tflite::BuiltinOperator_LOGISTIC:          return resolver->AddLogistic();
+        case tflite::BuiltinOperator_MAX_POOL_2D:       return resolver->AddMaxPool2D();
+        case tflite::BuiltinOperator_MEAN:              return resolver->AddMean();
+        case tflite::BuiltinOperator_MUL:               return resolver->AddMul();
+        case tflite::BuiltinOperator_PAD:               return resolver->AddPad();
+        case tflite::BuiltinOperator_QUANTIZE:          return resolver->AddQuantize();
+        case tflite::BuiltinOperator_RELU:              return resolver->AddRelu();
+        case tflite::BuiltinOperator_RELU6:             return resolver->AddRelu6();
+        case tflite::BuiltinOperator_RESHAPE:           return resolver->AddReshape();
+        case tflite::BuiltinOperator_SOFTMAX:           return resolver->AddSoftmax();
+        case tflite::BuiltinOperator_STRIDED_SLICE:     return resolver->AddStridedSlice();
+        default:                                        return kTfLiteError;
+    }
+}
+
+bool buildOpResolver(const tflite::Model* model, ModelOpResolver* resolver) {
+    const auto* op_codes = model->operator_codes();
+    if (op_codes == nullptr) {
+        return false;
+    }
+
+    // Каждая операция регистрируется один раз, даже если встречается в нескольких кодах
+    int registered[MODEL_MAX_OPS];
+    int count = 0;
+    for (unsigned i = 0; i < op_codes->size(); i++) {
+        // Код операции - большее из deprecated_builtin_code и builtin_code,
+        // как в TFLM и tools/pack_model.py
+        int op = tflite::GetBuiltinCode(op_codes->Get(i));
+        bool seen = false;
+        for (int j = 0; j < count; j++) {
+            seen = seen || registered[j] == op;
+        }
+        if (seen) {
+            continue;
+        }
+        if (count >= MODEL_MAX_OPS || addBuiltinOp(resolver, (tflite::BuiltinOperator)op) != kTfLiteOk) {
+            DIAG_ERROR("Операция модели не поддерживается менеджером: ");
+            DIAG_ERRORLN(op);
+            return false;
+        }
+        registered[count++] = op;
+    }
+    return true;
+}
+
+void modelManagerBegin(ModelManager* manager, uint8_t* arena, size_t arena_size,
+                       tflite::ErrorReporter* error_reporter) {
+    manager->num_models = 0;
+    manager->active = -1;
+    manager->arena = arena;
+    manager->arena_size = arena_size;
+    manager->error_reporter = error_reporter;
+    manager->interpreter = nullptr;
+    manager->switches = 0;
+    manager->switch_us = 0;
+}
+
+int modelManagerAdd(ModelManager* manager, const char* name, const void* model_data) {
+    if (manager->num_models >= MODEL_MAX_MODELS) {
+        return -1;
+    }
+    const tflite::Model* model = tflite::GetModel(model_data);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        DIAG_ERROR("Несовместимая версия схемы модели: ");
+        DIAG_ERRORLN(name);
+        return -1;
+    }
+
+    ManagedModel& managed = manager->models[manager->num_models];
+    new (&managed.resolver) ModelOpResolver();
+    if (!buildOpResolver(model, &managed.resolver)) {
+        return -1;
+    }
+    managed.name = name;
+    managed.model = model;
+    managed.invocations = 0;
+    managed.total_us = 0;
+    managed.max_us = 0;
+    return manager->num_models++;
+}
+
+tflite::MicroInterpreter* modelManagerActivate(ModelManager* manager, int index) {
+    if (index == manager->active) {
+        return manager->interpreter;
+    }
+
+    // Тензоры прежней модели больше не нужны - арена переходит новой
+    uint32_t start = micros();
+    if (manager->interpreter != nullptr) {
+        manager->interpreter->~MicroInterpreter();
+        manager->interpreter = nullptr;
+    }
+    manager->active = -1;
+
+    ManagedModel& managed = manager->models[index];
+    tflite::MicroInterpreter* interpreter = new (manager->interpreter_storage) tflite::MicroInterpreter(
+        managed.model, managed.resolver, manager->arena, manager->arena_size, manager->error_reporter);
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+        interpreter->~MicroInterpreter();
+        DIAG_ERROR("Ошибка выделения тензоров модели: ");
+        DIAG_ERRORLN(managed.name);
+        return nullptr;
+    }
+
+    manager->interpreter = interpreter;
+    manager->active = index;
+    manager->switches++;
+    manager->switch_us += micros() - start;
+    return interpreter;
+}
+
+void modelManagerEnd(ModelManager* manager) {
+    if (manager->interpreter != nullptr) {
+        manager->interpreter->~MicroInterpreter();
+        manager->interpreter = nullptr;
+    }
+    manager->active = -1;
+}
+
+TfLiteStatus modelManagerInvoke(ModelManager* manager, int index, const float* input, int input_size,
+                                float* scores) {
+    tflite::MicroInterpreter* interpreter = modelManagerActivate(manager, index);
+    if (interpreter == nullptr) {
+        return kTfLiteError;
+    }
+    TfLiteTensor* input_tensor = interpreter->input(0);
+    TfLiteTensor* output_tensor = interpreter->output(0);
+    if (input_tensor->type != kTfLiteFloat32 || input_tensor->bytes != input_size * sizeof(float) ||
+        output_tensor->bytes < NUM_CLASSES * sizeof(float)) {
+        return kTfLiteError;
+    }
+
+    memcpy(input_tensor->data.f, input, input_size * sizeof(float));
+    uint32_t start = micros();
+    TfLiteStatus status = interpreter->Invoke();
+    uint32_t elapsed = micros() - start;
+    if (status != kTfLiteOk) {
+        return status;
+    }
+
+    ManagedModel& managed = manager->models[index];
+    managed.invocations++;
+    managed.total_us += elapsed;
+    managed.max_us = elapsed > managed.max_us ? elapsed : managed.max_us;
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        scores[i] = output_tensor->data.f[i];
+    }
+    return kTfLiteOk;
+}
+
+TfLiteStatus runCascade(ModelManager* manager, CascadePolicy* policy, const float* input, int input_size,
+                        float* scores) {
+    policy->windows++;
+    TfLiteStatus status = modelManagerInvoke(manager, policy->general, input, input_size, scores);
+    if (status != kTfLiteOk || policy->specialist < 0) {
+        return status;
+    }
+
+    // Лучшая и вторая оценки общей модели
+    float best = scores[0];
+    float second = -1.0f;
+    for (int i = 1; i < NUM_CLASSES; i++) {
+        if (scores[i] > best) {
+            second = best;
+            best = scores[i];
+        } else if (scores[i] > second) {
+            second = scores[i];
+        }
+    }
+
+    if (best >= CASCADE_CONFIDENT_SCORE && best - second >= CASCADE_MIN_MARGIN) {
+        return kTfLiteOk;
+    }
+    policy->escalations++;
+    return modelManagerInvoke(manager, policy->specialist, input, input_size, scores);
+}
+
+void reportModelManager(const ModelManager& manager, const CascadePolicy& policy) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("=== МОДЕЛИ ===");
+    for (int i = 0; i < manager.num_models; i++) {
+        const ManagedModel& managed = manager.models[i];
+        Serial.print(managed.name); Serial.print(": вызовов "); Serial.print(managed.invocations);
+        if (managed.invocations > 0) {
+            Serial.print(", среднее "); Serial.print(managed.total_us / managed.invocations);
+            Serial.print(" мкс, максимум "); Serial.print(managed.max_us); Serial.print(" мкс");
+        }
+        Serial.println();
+    }
+    Serial.print("Смен модели в арене: "); Serial.print(manager.switches);
+    if (manager.switches > 0) {
+        Serial.print(", среднее "); Serial.print(manager.switch_us / manager.switches); Serial.print(" мкс");
+    }
+    Serial.println();
+    if (policy.specialist >= 0 && policy.windows > 0) {
+        Serial.print("Эскалаций в специализированную модель: ");
+        Serial.print(policy.escalations * 100.0f / policy.windows, 1); Serial.println("%");
+    }
+#endif
+}
@@ -0,0 +1,88 @@
+#ifndef MODEL_MANAGER_H
+#define MODEL_MANAGER_H
+
+#include <Arduino.h>
+#include <TensorFlowLite_ESP32.h>
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+#include "event_postprocessor.h"
+
+// Менеджер нескольких моделей (общая и специализированные под акустическую
+// обстановку). У каждой модели свой резолвер, построенный по списку операций
+// самой модели, вместо AllOpsResolver. Все модели делят одну тензорную арену:
+// в каждый момент в ней размещены тензоры только активной модели, при смене
+// модели интерпретатор пересоздается на той же арене (AllocateTensors заново).
+// Арена должна вмещать самую большую из моделей
+
+const int MODEL_MAX_MODELS = 4;
+const int MODEL_MAX_OPS = 16;  // различных операций в одной модели
+
+typedef tflite::MicroMutableOpResolver<MODEL_MAX_OPS> ModelOpResolver;
+
+// Резолвер по операциям из model->operator_codes(). false - в модели есть
+// операция, которую не умеет регистрировать менеджер
+bool buildOpResolver(const tflite::Model* model, ModelOpResolver* resolver);
+
+struct ManagedModel {
+    const char* name;
+    const tflite::Model* model;
+    ModelOpResolver resolver;
+    uint32_t invocations;
+    uint32_t total_us;
+    uint32_t max_us;
+};
+
+struct ModelManager {
+    ManagedModel models[MODEL_MAX_MODELS];
+    int num_models;
+    int active;                                  // -1 - арена пуста
+    uint8_t* arena;
+    size_t arena_size;
+    tflite::ErrorReporter* error_reporter;
+    tflite::MicroInterpreter* interpreter;
+    alignas(tflite::MicroInterpreter) uint8_t interpreter_storage[sizeof(tflite::MicroInterpreter)];
+    uint32_t switches;                           // пересозданий интерпретатора
+    uint32_t switch_us;                          // суммарное время пересоздания
+};
+
+void modelManagerBegin(ModelManager* manager, uint8_t* arena, size_t arena_size,
+                       tflite::ErrorReporter* error_reporter);
+
+// Регистрация модели. Возвращает ее индекс или -1 (версия схемы,
+// неизвестная операция, переполнение таблицы)
+int modelManagerAdd(ModelManager* manager, const char* name, const void* model_data);
+
+// Размещение тензоров модели в общей арене (если активна другая модель).
+// nullptr - AllocateTensors не прошел
+tflite::MicroInterpreter* modelManagerActivate(ModelManager* manager, int index);
+
+// Уничтожение интерпретатора, арена свободна (менеджер можно начать заново)
+void modelManagerEnd(ModelManager* manager);
+
+// Копирование входа, Invoke() и учет времени. Оценки классов копируются
+// в scores: после смены модели тензоры прежней модели недействительны
+TfLiteStatus modelManagerInvoke(ModelManager* manager, int index, const float* input, int input_size,
+                                float* scores);
+
+// Каскад: сначала общая модель, специализированная - только если оценки
+// общей неоднозначны (лучшая ниже CASCADE_CONFIDENT_SCORE или отрыв от второй
+// меньше CASCADE_MIN_MARGIN). specialist = -1 - каскад из одной модели
+const float CASCADE_CONFIDENT_SCORE = 0.6f;
+const float CASCADE_MIN_MARGIN = 0.2f;
+
+struct CascadePolicy {
+    int general;
+    int specialist;
+    uint32_t windows;
+    uint32_t escalations;                        // окон, ушедших в специализированную модель
+};
+
+TfLiteStatus runCascade(ModelManager* manager, CascadePolicy* policy, const float* input, int input_size,
+                        float* scores);
+
+// Число вызовов и задержка по моделям, смены моделей, доля эскалаций
+void reportModelManager(const ModelManager& manager, const CascadePolicy& policy);
+
+#endif // MODEL_MANAGER_H
@@ -0,0 +1,49 @@
+#include "onset_detector.h"
+#include <math.h>
+
+void resetOnsetDetector(OnsetDetector* detector) {
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        detector->prev_log_mel[mel] = 0;
+    }
+    detector->flux_mean = 0;
+    detector->flux = 0;
+    detector->has_prev = false;
+    detector->above = false;
+    detector->frames_since_onset = ONSET_MIN_INTERVAL_FRAMES;
+}
+
+bool onsetDetectorUpdate(OnsetDetector* detector, const float* mel_energies) {
+    // Положительный прирост логарифмической энергии по полосам
+    float flux = 0;
+    for (int mel = 0; mel < NUM_MELS; mel++) {
+        float v = logf(1.0f + ONSET_LOG_GAIN * mel_energies[mel]);
+        float d = v - detector->prev_log_mel[mel];
+        flux += d > 0 ? d : 0;
+        detector->prev_log_mel[mel] = v;
+    }
+    flux /= NUM_MELS;
+    detector->flux = flux;
+
+    // Первый кадр после сброса только задает опорный спектр
+    if (!detector->has_prev) {
+        detector->has_prev = true;
+        return false;
+    }
+
+    float threshold = detector->flux_mean * ONSET_THRESHOLD_RATIO + ONSET_THRESHOLD_DELTA;
+    bool above = flux > threshold;
+    bool onset = above && !detector->above && detector->frames_since_onset >= ONSET_MIN_INTERVAL_FRAMES;
+    detector->above = above;
+
+    // Фон обновляется только кадрами ниже порога, чтобы событие не поднимало порог
+    if (!above) {
+        detector->flux_mean += ONSET_MEAN_ALPHA * (flux - detector->flux_mean);
+    }
+
+    if (onset) {
+        detector->frames_since_onset = 0;
+    } else if (detector->frames_since_onset < ONSET_MIN_INTERVAL_FRAMES) {
+        detector->frames_since_onset++;
+    }
+    return onset;
+}
@@ -0,0 +1,40 @@
+#ifndef ONSET_DETECTOR_H
+#define ONSET_DETECTOR_H
+
+#include "audio_processing.h"
+
+// Детектор онсетов по спектральному потоку (spectral flux) между
+// соседними мель-кадрами потокового фронтенда:
+//   flux = mean_mel max(0, log(1 + g*m[t]) - log(1 + g*m[t-1]))
+// Онсет - переход flux через адаптивный порог (среднее фона * ratio + delta)
+// не чаще раза в ONSET_MIN_INTERVAL_FRAMES кадров. Инференс ставится так,
+// чтобы онсет оказался в кадре ONSET_WINDOW_FRAME окна модели.
+// Не зависит от Arduino - пороги настраиваются на записях на хосте
+
+const float ONSET_LOG_GAIN = 1000.0f;         // сжатие мель-энергий перед разностью
+const float ONSET_MEAN_ALPHA = 0.02f;         // сглаживание фона (~50 кадров = 0.5 с)
+const float ONSET_THRESHOLD_RATIO = 2.0f;
+const float ONSET_THRESHOLD_DELTA = 0.3f;     // минимальный средний прирост, непер на полосу
+const int ONSET_MIN_INTERVAL_FRAMES = NUM_FRAMES / 2;
+
+// Положение онсета в окне модели: 12 кадров (120 мс) до начала события
+const int ONSET_WINDOW_FRAME = 12;
+
+// Шагов от кадра онсета до окна, в котором онсет стоит в ONSET_WINDOW_FRAME
+const int ONSET_INFERENCE_DELAY_HOPS = NUM_FRAMES - 1 - ONSET_WINDOW_FRAME;
+
+struct OnsetDetector {
+    float prev_log_mel[NUM_MELS];
+    float flux_mean;                // средний поток фона
+    float flux;                     // поток последнего кадра
+    bool has_prev;
+    bool above;                     // предыдущий кадр был выше порога
+    int frames_since_onset;
+};
+
+void resetOnsetDetector(OnsetDetector* detector);
+
+// Обработка очередного кадра. true - в этом кадре начинается событие
+bool onsetDetectorUpdate(OnsetDetector* detector, const float* mel_energies);
+
+#endif // ONSET_DETECTOR_H
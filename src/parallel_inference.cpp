@@ -0,0 +1,138 @@
+#include "parallel_inference.h"
+#include "alloc_tracker.h"
+#include "diagnostics.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+const int PARALLEL_CHECK_RUNS = 5;
+
+static tflite::MicroInterpreter* worker_interpreter = nullptr;
+static TaskHandle_t worker_task = nullptr;
+static TaskHandle_t caller_task = nullptr;
+static TfLiteStatus worker_status = kTfLiteOk;
+static int worker_input_size = 0;
+
+static void inferenceWorkerTask(void* arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stackBudgetBegin();
+        worker_status = worker_interpreter->Invoke();
+        stackBudgetEnd();
+        xTaskNotifyGive(caller_task);
+    }
+}
+
+bool parallelInferenceBegin(const tflite::Model* model, const tflite::MicroOpResolver& resolver,
+                            uint8_t* arena, size_t arena_size, tflite::ErrorReporter* error_reporter,
+                            int input_size) {
+    if (worker_task != nullptr) {
+        return true;
+    }
+
+    static tflite::MicroInterpreter interpreter(model, resolver, arena, arena_size, error_reporter);
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+        return false;
+    }
+    TfLiteTensor* input = interpreter.input(0);
+    TfLiteTensor* output = interpreter.output(0);
+    if (input == nullptr || output == nullptr || input->type != kTfLiteFloat32 ||
+        input->bytes != input_size * sizeof(float) || output->type != kTfLiteFloat32 ||
+        output->bytes != SECONDARY_NUM_OUTPUTS * sizeof(float)) {
+        return false;
+    }
+    worker_interpreter = &interpreter;
+    worker_input_size = input_size;
+
+    BaseType_t created = xTaskCreatePinnedToCore(inferenceWorkerTask, "inference", INFERENCE_WORKER_STACK_SIZE,
+                                                 nullptr, INFERENCE_WORKER_PRIORITY, &worker_task,
+                                                 INFERENCE_WORKER_CORE);
+    if (created != pdPASS) {
+        worker_task = nullptr;
+        return false;
+    }
+    stackBudgetRegisterTask(worker_task, INFERENCE_WORKER_STACK_SIZE, INFERENCE_WORKER_STACK_BUDGET);
+    return true;
+}
+
+bool parallelInferenceEnabled() {
+    return worker_task != nullptr;
+}
+
+void parallelInferenceStart(const float* input) {
+    memcpy(worker_interpreter->input(0)->data.f, input, worker_input_size * sizeof(float));
+    caller_task = xTaskGetCurrentTaskHandle();
+    xTaskNotifyGive(worker_task);
+}
+
+TfLiteStatus parallelInferenceWait(float* scores) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (worker_status != kTfLiteOk) {
+        return worker_status;
+    }
+    const float* output = worker_interpreter->output(0)->data.f;
+    for (int i = 0; i < SECONDARY_NUM_OUTPUTS; i++) {
+        scores[i] = output[i];
+    }
+    return kTfLiteOk;
+}
+
+void parallelInferenceMerge(const float* secondary_scores, float* scores) {
+    for (int i = 0; i < SECONDARY_NUM_OUTPUTS; i++) {
+        int c = SECONDARY_CLASS_MAP[i];
+        scores[c] = secondary_scores[i] > scores[c] ? secondary_scores[i] : scores[c];
+    }
+}
+
+size_t parallelInferenceArenaUsed() {
+    return worker_interpreter != nullptr ? worker_interpreter->arena_used_bytes() : 0;
+}
+
+void reportParallelInference(const float* input, TfLiteStatus (*run_local)(const float* input),
+                             size_t local_arena_used) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== ПАРАЛЛЕЛЬНЫЙ ИНФЕРЕНС ===");
+    if (!parallelInferenceEnabled()) {
+        Serial.println("Второй интерпретатор не запущен");
+        return;
+    }
+
+    float scores[SECONDARY_NUM_OUTPUTS];
+    // Ошибки считаются отдельно: каждый Start() обязательно завершается
+    // Wait(), иначе следующий Wait() забрал бы устаревшее уведомление
+    int local_errors = 0;
+    int worker_errors = 0;
+
+    // Последовательно: обе модели по очереди, ядро 1 ждет ядро 0
+    uint32_t start = micros();
+    for (int run = 0; run < PARALLEL_CHECK_RUNS; run++) {
+        local_errors += run_local(input) != kTfLiteOk;
+        parallelInferenceStart(input);
+        worker_errors += parallelInferenceWait(scores) != kTfLiteOk;
+    }
+    uint32_t serial_us = micros() - start;
+
+    // Параллельно: Invoke() на обоих ядрах одновременно
+    start = micros();
+    for (int run = 0; run < PARALLEL_CHECK_RUNS; run++) {
+        parallelInferenceStart(input);
+        local_errors += run_local(input) != kTfLiteOk;
+        worker_errors += parallelInferenceWait(scores) != kTfLiteOk;
+    }
+    uint32_t parallel_us = micros() - start;
+
+    if (local_errors != 0 || worker_errors != 0 || serial_us == 0 || parallel_us == 0) {
+        Serial.print("Ошибка инференса при замере: ядро 1 "); Serial.print(local_errors);
+        Serial.print(", ядро 0 "); Serial.print(worker_errors);
+        Serial.print(" из "); Serial.println(2 * PARALLEL_CHECK_RUNS);
+        return;
+    }
+    Serial.print("Пар окон в секунду: последовательно ");
+    Serial.print(PARALLEL_CHECK_RUNS * 1e6f / serial_us, 2);
+    Serial.print(", на двух ядрах "); Serial.println(PARALLEL_CHECK_RUNS * 1e6f / parallel_us, 2);
+    Serial.print("Масштабирование: x"); Serial.println((float)serial_us / parallel_us, 2);
+    Serial.print("Арены: ядро 1 "); Serial.print(local_arena_used);
+    Serial.print(" байт, ядро 0 "); Serial.print(parallelInferenceArenaUsed());
+    Serial.println(" байт");
+#endif
+}
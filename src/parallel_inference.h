@@ -0,0 +1,65 @@
+#ifndef PARALLEL_INFERENCE_H
+#define PARALLEL_INFERENCE_H
+
+#include <Arduino.h>
+#include <TensorFlowLite_ESP32.h>
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "event_postprocessor.h"
+
+// Второй интерпретатор на ядре 0 со своей ареной (сборка с -DPARALLEL_INFERENCE).
+// Пока loop() на ядре 1 выполняет свой Invoke(), рабочая задача выполняет
+// Invoke() второй модели на тех же признаках окна (например, детектор
+// переходных звуков и детектор скрипа). Каждый parallelInferenceStart()
+// должен завершаться parallelInferenceWait(), даже если Invoke() на ядре 1
+// не удался. Fork/join - уведомления задач FreeRTOS, как у параллельного
+// фронтенда.
+// Обе арены в PSRAM: пропускная способность PSRAM общая, поэтому ускорение
+// меньше двукратного и измеряется при загрузке (reportParallelInference)
+
+const BaseType_t INFERENCE_WORKER_CORE = 0;
+const uint32_t INFERENCE_WORKER_STACK_SIZE = 8192;  // байт, Invoke() TFLM
+const uint32_t INFERENCE_WORKER_STACK_BUDGET = 6144; // байт на Invoke() (alloc_tracker.h)
+const UBaseType_t INFERENCE_WORKER_PRIORITY = 2;
+
+// Классы второго детектора: выход i его модели - класс SECONDARY_CLASS_MAP[i]
+// общей разметки (class_names). Детектор отвечает только за свои классы,
+// остальные оценки окна дает каскад. По умолчанию - детектор скрипа с одним выходом
+constexpr int SECONDARY_CLASS_MAP[] = {2};
+constexpr int SECONDARY_NUM_OUTPUTS = sizeof(SECONDARY_CLASS_MAP) / sizeof(SECONDARY_CLASS_MAP[0]);
+
+constexpr bool secondaryClassMapValid(int i = 0) {
+    return i == SECONDARY_NUM_OUTPUTS ||
+           (SECONDARY_CLASS_MAP[i] >= 0 && SECONDARY_CLASS_MAP[i] < NUM_CLASSES && secondaryClassMapValid(i + 1));
+}
+static_assert(SECONDARY_NUM_OUTPUTS <= NUM_CLASSES && secondaryClassMapValid(),
+              "SECONDARY_CLASS_MAP ссылается на несуществующий класс");
+
+// Интерпретатор создается и размещает тензоры в arena. false - модель
+// не подходит (вход не float32 размером input_size, выход не из
+// SECONDARY_NUM_OUTPUTS float32) или не хватило арены
+bool parallelInferenceBegin(const tflite::Model* model, const tflite::MicroOpResolver& resolver,
+                            uint8_t* arena, size_t arena_size, tflite::ErrorReporter* error_reporter,
+                            int input_size);
+bool parallelInferenceEnabled();
+
+// Fork: вход копируется во входной тензор, Invoke() уходит на ядро 0
+void parallelInferenceStart(const float* input);
+
+// Join: ожидание Invoke() на ядре 0, оценки SECONDARY_NUM_OUTPUTS выходов
+// копируются в scores (классы - SECONDARY_CLASS_MAP)
+TfLiteStatus parallelInferenceWait(float* scores);
+
+// Объединение с оценками каскада: класс второго детектора получает
+// максимум двух оценок, остальные классы не меняются
+void parallelInferenceMerge(const float* secondary_scores, float* scores);
+
+// Байт арены, занятых вторым интерпретатором
+size_t parallelInferenceArenaUsed();
+
+// Пропускная способность: окон в секунду при последовательном выполнении
+// обеих моделей на ядре 1 и при параллельном на двух ядрах, цена арен.
+// run_local выполняет Invoke() модели ядра 1 на input
+void reportParallelInference(const float* input, TfLiteStatus (*run_local)(const float* input),
+                             size_t local_arena_used);
+
+#endif // PARALLEL_INFERENCE_H
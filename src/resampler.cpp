@@ -0,0 +1,166 @@
+#include "resampler.h"
+#include "frontend_kernels.h"
+#include <math.h>
+#include <string.h>
+
+static int16_t saturate16(int32_t value) {
+    return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : (int16_t)value);
+}
+
+// Скалярное ядро (устройство). На Xtensa компилятор сводит цикл к MULA
+static int32_t dotScalar(const int16_t* samples, const int16_t* coeffs, int taps) {
+    int32_t acc = 0;
+    for (int i = 0; i < taps; i++) {
+        acc += (int32_t)samples[i] * coeffs[i];
+    }
+    return acc;
+}
+
+#ifdef FRONTEND_HAS_AVX2
+#include <immintrin.h>
+
+// 16 произведений за шаг; madd складывает пары в int32 без потери точности
+__attribute__((target("avx2")))
+static int32_t dotAvx2(const int16_t* samples, const int16_t* coeffs, int taps) {
+    __m256i acc = _mm256_setzero_si256();
+    for (int i = 0; i < taps; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(samples + i));
+        __m256i h = _mm256_loadu_si256((const __m256i*)(coeffs + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, h));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+#ifdef FRONTEND_HAS_NEON
+#include <arm_neon.h>
+
+static int32_t dotNeon(const int16_t* samples, const int16_t* coeffs, int taps) {
+    int32x4_t acc0 = vdupq_n_s32(0);
+    int32x4_t acc1 = vdupq_n_s32(0);
+    for (int i = 0; i < taps; i += 8) {
+        int16x8_t x = vld1q_s16(samples + i);
+        int16x8_t h = vld1q_s16(coeffs + i);
+        acc0 = vmlal_s16(acc0, vget_low_s16(x), vget_low_s16(h));
+        acc1 = vmlal_high_s16(acc1, x, h);
+    }
+    return vaddvq_s32(vaddq_s32(acc0, acc1));
+}
+#endif
+
+static void selectKernel(Resampler* rs) {
+    resamplerUseScalarKernel(rs);
+#ifdef FRONTEND_HAS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        rs->dot = dotAvx2;
+        rs->kernel_name = "avx2";
+    }
+#endif
+#ifdef FRONTEND_HAS_NEON
+    rs->dot = dotNeon;
+    rs->kernel_name = "neon";
+#endif
+}
+
+// Модифицированная функция Бесселя нулевого порядка (ряд)
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Прототип длиной up * taps на частоте up * in_rate. Переходная полоса
+// (~3.6 * in_rate / taps для beta = 6) заканчивается на половине меньшей из
+// частот: алиасинг в полосу фронтенда подавлен, ослабление - у самого верха
+static void designFilter(Resampler* rs, int16_t* coeffs) {
+    int length = rs->up * rs->taps;
+    double prototype_rate = (double)rs->up * rs->in_rate;
+    double nyquist = 0.5 * (rs->in_rate < rs->out_rate ? rs->in_rate : rs->out_rate);
+    double transition = 3.6 * rs->in_rate / rs->taps;
+    double cutoff = (nyquist - 0.5 * transition) / prototype_rate;
+    double center = 0.5 * (length - 1);
+    double i0_beta = besselI0(RESAMPLER_KAISER_BETA);
+
+    // Отвод n прототипа попадает в фазу n % up на позицию n / up. В таблице
+    // позиции хранятся в обратном порядке, как лежат отсчеты в линии задержки
+    for (int n = 0; n < length; n++) {
+        double t = n - center;
+        double sinc = t == 0.0 ? 1.0 : sin(2.0 * M_PI * cutoff * t) / (2.0 * M_PI * cutoff * t);
+        double r = 2.0 * n / (length - 1) - 1.0;
+        double window = besselI0(RESAMPLER_KAISER_BETA * sqrt(1.0 - r * r)) / i0_beta;
+        // Усиление up компенсирует нули, вставленные между входными отсчетами
+        double h = 2.0 * cutoff * sinc * window * rs->up;
+        int phase = n % rs->up;
+        int position = n / rs->up;
+        coeffs[phase * rs->taps + (rs->taps - 1 - position)] = saturate16((int32_t)lround(h * 32768.0));
+    }
+}
+
+bool resamplerInit(Resampler* rs, int in_rate, int out_rate, int16_t* coeffs, int coeffs_capacity) {
+    int taps = resamplerTaps(in_rate, out_rate);
+    if (taps > RESAMPLER_MAX_TAPS || resamplerTableSize(in_rate, out_rate) > coeffs_capacity) {
+        return false;
+    }
+    int gcd = resamplerGcd(in_rate, out_rate);
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->up = out_rate / gcd;
+    rs->down = in_rate / gcd;
+    rs->taps = taps;
+    rs->coeffs = coeffs;
+    designFilter(rs, coeffs);
+    selectKernel(rs);
+    resamplerReset(rs);
+    return true;
+}
+
+void resamplerUseScalarKernel(Resampler* rs) {
+    rs->dot = dotScalar;
+    rs->kernel_name = "scalar";
+}
+
+void resamplerReset(Resampler* rs) {
+    memset(rs->line, 0, sizeof(rs->line));
+    rs->write = 0;
+    rs->phase = rs->up;
+}
+
+int resamplerProcess(Resampler* rs, const int16_t* in, int in_count, int* consumed,
+                     int16_t* out, int out_capacity) {
+    int produced = 0;
+    int used = 0;
+    for (;;) {
+        // Выходы, для которых входа уже достаточно
+        while (rs->phase < rs->up) {
+            if (produced == out_capacity) {
+                *consumed = used;
+                return produced;
+            }
+            int32_t acc = rs->dot(rs->line + rs->write, rs->coeffs + rs->phase * rs->taps, rs->taps);
+            out[produced++] = saturate16((acc + (1 << 14)) >> 15);
+            rs->phase += rs->down;
+        }
+        if (used == in_count) {
+            break;
+        }
+        int16_t sample = in[used++];
+        rs->line[rs->write] = sample;
+        rs->line[rs->write + rs->taps] = sample;
+        rs->write = rs->write + 1 == rs->taps ? 0 : rs->write + 1;
+        rs->phase -= rs->up;
+    }
+    *consumed = used;
+    return produced;
+}
+
+float resamplerDelay(const Resampler& rs) {
+    return 0.5f * (rs.up * rs.taps - 1) / rs.down;
+}
@@ -0,0 +1,79 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+
+// Потоковый полифазный ресемплер int16 -> int16 (частота входа -> частота
+// фронтенда). Отношение частот сокращается до up/down, прототип ФНЧ (sinc
+// с окном Кайзера) строится при инициализации и разбивается на up фаз
+// по taps коэффициентов Q15. Каждый выходной отсчет - одно скалярное
+// произведение taps отсчетов входа на одну фазу: стоимость на отсчет
+// ограничена и не зависит от положения во входном потоке.
+// Арифметика целочисленная (накопление в int32, округление и насыщение),
+// поэтому векторные ядра хоста (AVX2, NEON) дают результат бит в бит
+// со скалярным ядром устройства
+
+const int RESAMPLER_TAPS_ALIGN = 16;     // длина фазы кратна ширине векторного ядра
+const int RESAMPLER_BASE_TAPS = 32;      // длина фазы без понижения частоты
+const int RESAMPLER_MAX_TAPS = 192;      // понижение до 6 раз (96 кГц -> 16 кГц)
+const double RESAMPLER_KAISER_BETA = 6.0;  // ~60 дБ подавления в полосе задерживания
+
+constexpr int resamplerGcd(int a, int b) {
+    return b == 0 ? a : resamplerGcd(b, a % b);
+}
+
+// Число фаз (up) для пары частот
+constexpr int resamplerPhases(int in_rate, int out_rate) {
+    return out_rate / resamplerGcd(in_rate, out_rate);
+}
+
+// Длина фазы: при понижении в k раз прототип удлиняется в k раз, чтобы
+// переходная полоса осталась той же относительно выходной частоты
+constexpr int resamplerTaps(int in_rate, int out_rate) {
+    return ((RESAMPLER_BASE_TAPS * ((in_rate + out_rate - 1) / out_rate) + RESAMPLER_TAPS_ALIGN - 1) /
+            RESAMPLER_TAPS_ALIGN) * RESAMPLER_TAPS_ALIGN;
+}
+
+// Размер таблицы коэффициентов, int16
+constexpr int resamplerTableSize(int in_rate, int out_rate) {
+    return resamplerPhases(in_rate, out_rate) * resamplerTaps(in_rate, out_rate);
+}
+
+struct Resampler {
+    int in_rate;
+    int out_rate;
+    int up;                              // фаз на входной отсчет
+    int down;                            // шаг по фазам на выходной отсчет
+    int taps;
+    int phase;                           // фаза следующего выхода; >= up - нужен новый вход
+    int write;                           // позиция записи в линии задержки
+    const int16_t* coeffs;               // [up][taps], Q15, в обратном порядке (старый отсчет первым)
+    int32_t (*dot)(const int16_t* samples, const int16_t* coeffs, int taps);
+    const char* kernel_name;
+    // Каждый отсчет пишется дважды (write и write + taps): последние taps
+    // отсчетов всегда лежат подряд с позиции write
+    int16_t line[2 * RESAMPLER_MAX_TAPS];
+};
+
+// Построение фильтра в coeffs (не меньше resamplerTableSize(in_rate, out_rate)
+// элементов) и выбор ядра. false - длина фазы больше RESAMPLER_MAX_TAPS или
+// таблица не помещается
+bool resamplerInit(Resampler* rs, int in_rate, int out_rate, int16_t* coeffs, int coeffs_capacity);
+
+// Скалярное ядро устройства вместо выбранного векторного (эталон для
+// сравнения ядер хоста, как kScalarFrontendBackend у фронтенда)
+void resamplerUseScalarKernel(Resampler* rs);
+
+// Сброс линии задержки и фазы (новый поток; фильтр сохраняется)
+void resamplerReset(Resampler* rs);
+
+// Обработка очередного куска входа. Возвращает число записанных выходных
+// отсчетов (не больше out_capacity); *consumed - сколько входных отсчетов
+// использовано. Неиспользованный остаток входа подается следующим вызовом
+int resamplerProcess(Resampler* rs, const int16_t* in, int in_count, int* consumed,
+                     int16_t* out, int out_capacity);
+
+// Групповая задержка фильтра в выходных отсчетах
+float resamplerDelay(const Resampler& rs);
+
+#endif // RESAMPLER_H
@@ -0,0 +1,218 @@
+#include "signal_stats.h"
+#include <float.h>
+#include <math.h>
+
+// Все циклы ниже написаны без ветвлений и с локальными аккумуляторами,
+// чтобы компилятор мог их векторизовать (SSE/NEON на хосте, PIE на ESP32-S3).
+// Исключение - кондиционирование: рекурсивный фильтр последователен по отсчетам
+
+void initConditioner(SignalConditioner* conditioner, float dc_pole, float preemphasis, float gain) {
+    // (1 - z^-1)(1 - p z^-1) = 1 - (1 + p) z^-1 + p z^-2
+    conditioner->b0 = gain;
+    conditioner->b1 = -gain * (1.0f + preemphasis);
+    conditioner->b2 = gain * preemphasis;
+    conditioner->a1 = -dc_pole;
+    resetConditioner(conditioner);
+}
+
+void resetConditioner(SignalConditioner* conditioner) {
+    conditioner->s1 = 0;
+    conditioner->s2 = 0;
+    conditioner->primed = false;
+}
+
+void resetStats(Int16Stats* stats) {
+    stats->min = INT16_MAX;
+    stats->max = INT16_MIN;
+    stats->sum = 0;
+    stats->sum_sq = 0;
+    stats->count_above = 0;
+    stats->count = 0;
+}
+
+void resetStats(FloatStats* stats) {
+    stats->min = FLT_MAX;
+    stats->max = -FLT_MAX;
+    stats->sum = 0;
+    stats->sum_sq = 0;
+    stats->count_above = 0;
+    stats->count = 0;
+}
+
+void accumulateStats(const int16_t* data, int size, int16_t threshold, Int16Stats* stats) {
+    int32_t mn = stats->min;
+    int32_t mx = stats->max;
+    int32_t sum = 0;
+    float sum_sq = 0;
+    int above = 0;
+
+    for (int i = 0; i < size; i++) {
+        int32_t v = data[i];
+        int32_t a = v < 0 ? -v : v;
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        sum_sq += (float)(v * v);
+        above += a > threshold;
+    }
+
+    stats->min = (int16_t)mn;
+    stats->max = (int16_t)mx;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+    stats->count_above += above;
+    stats->count += size;
+}
+
+void accumulateStats(const float* data, int size, float threshold, FloatStats* stats) {
+    float mn = stats->min;
+    float mx = stats->max;
+    float sum = 0;
+    float sum_sq = 0;
+    int above = 0;
+
+    for (int i = 0; i < size; i++) {
+        float v = data[i];
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        sum_sq += v * v;
+        above += v > threshold;
+    }
+
+    stats->min = mn;
+    stats->max = mx;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+    stats->count_above += above;
+    stats->count += size;
+}
+
+void mergeStats(const Int16Stats& part, Int16Stats* stats) {
+    stats->min = part.min < stats->min ? part.min : stats->min;
+    stats->max = part.max > stats->max ? part.max : stats->max;
+    stats->sum += part.sum;
+    stats->sum_sq += part.sum_sq;
+    stats->count_above += part.count_above;
+    stats->count += part.count;
+}
+
+void conditionSamplesWithStats(SignalConditioner* conditioner, int16_t* data, int size,
+                               int16_t threshold, Int16Stats* stats) {
+    const float b0 = conditioner->b0;
+    const float b1 = conditioner->b1;
+    const float b2 = conditioner->b2;
+    const float a1 = conditioner->a1;
+    if (!conditioner->primed && size > 0) {
+        // Установившееся состояние для постоянного входа data[0]: выход 0
+        conditioner->s2 = b2 * data[0];
+        conditioner->s1 = b1 * data[0] + conditioner->s2;
+        conditioner->primed = true;
+    }
+    float s1 = conditioner->s1;
+    float s2 = conditioner->s2;
+    int32_t mn = INT16_MAX;
+    int32_t mx = INT16_MIN;
+    int32_t sum = 0;
+    float sum_sq = 0;
+    int above = 0;
+
+    for (int i = 0; i < size; i++) {
+        float x = data[i];
+        float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x;
+        float r = y + (y < 0 ? -0.5f : 0.5f);
+        r = r > 32767.0f ? 32767.0f : (r < -32768.0f ? -32768.0f : r);
+        int32_t v = (int32_t)r;
+        data[i] = (int16_t)v;
+        int32_t a = v < 0 ? -v : v;
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        sum_sq += (float)(v * v);
+        above += a > threshold;
+    }
+
+    conditioner->s1 = s1;
+    conditioner->s2 = s2;
+    if (stats == nullptr) {
+        return;
+    }
+    stats->min = mn < stats->min ? (int16_t)mn : stats->min;
+    stats->max = mx > stats->max ? (int16_t)mx : stats->max;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+    stats->count_above += above;
+    stats->count += size;
+}
+
+void scaleWithStats(float* data, int size, float scale,
+                    float threshold, FloatStats* stats) {
+    float mn = stats->min;
+    float mx = stats->max;
+    float sum = 0;
+    float sum_sq = 0;
+    int above = 0;
+
+    for (int i = 0; i < size; i++) {
+        float v = data[i] * scale;
+        data[i] = v;
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        sum_sq += v * v;
+        above += v > threshold;
+    }
+
+    stats->min = mn;
+    stats->max = mx;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+    stats->count_above += above;
+    stats->count += size;
+}
+
+void affineClampWithStats(float* data, int size, float scale, float offset, float lo, float hi,
+                          float threshold, FloatStats* stats) {
+    float mn = stats->min;
+    float mx = stats->max;
+    float sum = 0;
+    float sum_sq = 0;
+    int above = 0;
+
+    for (int i = 0; i < size; i++) {
+        float v = data[i] * scale + offset;
+        v = v < lo ? lo : v;
+        v = v > hi ? hi : v;
+        data[i] = v;
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        sum_sq += v * v;
+        above += v > threshold;
+    }
+
+    stats->min = mn;
+    stats->max = mx;
+    stats->sum += sum;
+    stats->sum_sq += sum_sq;
+    stats->count_above += above;
+    stats->count += size;
+}
+
+float statsMean(const Int16Stats& stats) {
+    return stats.count > 0 ? (float)stats.sum / stats.count : 0.0f;
+}
+
+float statsMean(const FloatStats& stats) {
+    return stats.count > 0 ? stats.sum / stats.count : 0.0f;
+}
+
+float statsRms(const Int16Stats& stats) {
+    return stats.count > 0 ? sqrtf(stats.sum_sq / stats.count) : 0.0f;
+}
+
+float statsRms(const FloatStats& stats) {
+    return stats.count > 0 ? sqrtf(stats.sum_sq / stats.count) : 0.0f;
+}
@@ -0,0 +1,73 @@
+#ifndef SIGNAL_STATS_H
+#define SIGNAL_STATS_H
+
+#include <stdint.h>
+
+// Статистика блока отсчетов, собираемая за один проход по памяти.
+// Используется диагностикой и детектором активности вместо отдельных циклов.
+struct Int16Stats {
+    int16_t min;
+    int16_t max;
+    int32_t sum;        // Точна до 65536 отсчетов
+    float sum_sq;
+    int count_above;    // Отсчеты с |x| > threshold
+    int count;
+};
+
+struct FloatStats {
+    float min;
+    float max;
+    float sum;
+    float sum_sq;
+    int count_above;    // Отсчеты с x > threshold
+    int count;
+};
+
+// Потоковое кондиционирование входа: удаление постоянной составляющей,
+// предыскажение и усиление одним биквадом
+//   H(z) = gain * (1 - z^-1) * (1 - preemphasis * z^-1) / (1 - dc_pole * z^-1)
+// Состояние переносится между шагами, поэтому результат не зависит от
+// разбиения потока на блоки
+struct SignalConditioner {
+    float b0, b1, b2;
+    float a1;
+    float s1, s2;       // состояние (транспонированная форма II)
+    bool primed;        // состояние заполнено по первому отсчету
+};
+
+void initConditioner(SignalConditioner* conditioner, float dc_pole, float preemphasis, float gain);
+
+// Новый поток: первый отсчет принимается за постоянную составляющую, без
+// переходного процесса от скачка смещения
+void resetConditioner(SignalConditioner* conditioner);
+
+void resetStats(Int16Stats* stats);
+void resetStats(FloatStats* stats);
+
+// Накопление статистики по блоку (можно вызывать для нескольких блоков подряд)
+void accumulateStats(const int16_t* data, int size, int16_t threshold, Int16Stats* stats);
+void accumulateStats(const float* data, int size, float threshold, FloatStats* stats);
+
+// Добавление статистики другого блока (например, статистики шагов окна)
+void mergeStats(const Int16Stats& part, Int16Stats* stats);
+
+// Кондиционирование int16-блока на месте (с округлением и насыщением) со
+// сбором статистики результата в том же проходе. stats может быть nullptr
+void conditionSamplesWithStats(SignalConditioner* conditioner, int16_t* data, int size,
+                               int16_t threshold, Int16Stats* stats);
+
+// Масштабирование float-блока со сбором статистики результата в том же проходе
+void scaleWithStats(float* data, int size, float scale,
+                    float threshold, FloatStats* stats);
+
+// data[i] = clamp(data[i] * scale + offset, lo, hi) со сбором статистики
+// результата в том же проходе
+void affineClampWithStats(float* data, int size, float scale, float offset, float lo, float hi,
+                          float threshold, FloatStats* stats);
+
+float statsMean(const Int16Stats& stats);
+float statsMean(const FloatStats& stats);
+float statsRms(const Int16Stats& stats);
+float statsRms(const FloatStats& stats);
+
+#endif // SIGNAL_STATS_H
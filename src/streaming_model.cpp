@@ -0,0 +1,119 @@
+#include "streaming_model.h"
+#include <string.h>
+#include <math.h>
+
+bool streamingModelBegin(StreamingModel* model, tflite::MicroInterpreter* interpreter) {
+    model->interpreter = interpreter;
+    model->num_states = (int)interpreter->inputs_size() - 1;
+    if (model->num_states < 1 || model->num_states > STREAMING_MAX_STATES ||
+        interpreter->outputs_size() != interpreter->inputs_size()) {
+        return false;
+    }
+
+    model->frame_input = interpreter->input(0);
+    model->scores = interpreter->output(0);
+    if (model->frame_input == nullptr || model->scores == nullptr ||
+        model->frame_input->type != kTfLiteFloat32 || model->scores->type != kTfLiteFloat32 ||
+        model->frame_input->bytes != NUM_FEATURES * sizeof(float) ||
+        model->scores->bytes != NUM_CLASSES * sizeof(float)) {
+        return false;
+    }
+
+    for (int i = 0; i < model->num_states; i++) {
+        model->state_in[i] = interpreter->input(i + 1);
+        model->state_out[i] = interpreter->output(i + 1);
+        if (model->state_in[i] == nullptr || model->state_out[i] == nullptr ||
+            model->state_in[i]->type != model->state_out[i]->type ||
+            model->state_in[i]->bytes != model->state_out[i]->bytes) {
+            return false;
+        }
+    }
+
+    streamingModelReset(model);
+    return true;
+}
+
+void streamingModelReset(StreamingModel* model) {
+    for (int i = 0; i < model->num_states; i++) {
+        memset(model->state_in[i]->data.raw, 0, model->state_in[i]->bytes);
+    }
+}
+
+TfLiteStatus streamingModelStep(StreamingModel* model, const float* frame) {
+    memcpy(model->frame_input->data.f, frame, NUM_FEATURES * sizeof(float));
+
+    TfLiteStatus status = model->interpreter->Invoke();
+    if (status != kTfLiteOk) {
+        return status;
+    }
+
+    // Перенос состояния сверток на следующий шаг
+    for (int i = 0; i < model->num_states; i++) {
+        memcpy(model->state_in[i]->data.raw, model->state_out[i]->data.raw, model->state_in[i]->bytes);
+    }
+    return kTfLiteOk;
+}
+
+#ifdef ARDUINO
+#include "diagnostics.h"
+
+void reportStreamingModelParity(StreamingModel* model, tflite::MicroInterpreter* full_interpreter,
+                                float* spectrogram) {
+#if DIAG_ENABLED(DIAG_LEVEL_INFO)
+    Serial.println("\n=== ПОТОКОВАЯ МОДЕЛЬ ===");
+
+    // Детерминированная нормализованная спектрограмма в [0, 1]
+    uint32_t seed = 12345;
+    for (int i = 0; i < SPECTROGRAM_SIZE; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        spectrogram[i] = (seed >> 8) / 16777216.0f;
+    }
+
+    // Полная модель: все окно за один Invoke()
+    TfLiteTensor* full_input = full_interpreter->input(0);
+    if (full_input->type != kTfLiteFloat32) {
+        Serial.println("Сверка только для float32 модели");
+        return;
+    }
+    memcpy(full_input->data.f, spectrogram, SPECTROGRAM_SIZE * sizeof(float));
+    uint32_t start = ESP.getCycleCount();
+    TfLiteStatus full_status = full_interpreter->Invoke();
+    uint32_t full_cycles = ESP.getCycleCount() - start;
+
+    // Потоковая модель: NUM_FRAMES шагов по одному кадру (столбец спектрограммы)
+    streamingModelReset(model);
+    float frame[NUM_FEATURES];
+    uint32_t step_cycles = 0;
+    TfLiteStatus step_status = kTfLiteOk;
+    for (int f = 0; f < NUM_FRAMES && step_status == kTfLiteOk; f++) {
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            frame[i] = spectrogram[i * NUM_FRAMES + f];
+        }
+        start = ESP.getCycleCount();
+        step_status = streamingModelStep(model, frame);
+        step_cycles += ESP.getCycleCount() - start;
+    }
+    streamingModelReset(model);
+
+    if (full_status != kTfLiteOk || step_status != kTfLiteOk) {
+        Serial.println("Ошибка инференса при сверке");
+        return;
+    }
+
+    float max_diff = 0;
+    const float* full_scores = full_interpreter->output(0)->data.f;
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        float diff = fabsf(full_scores[i] - model->scores->data.f[i]);
+        max_diff = diff > max_diff ? diff : max_diff;
+    }
+
+    Serial.print("Тензоров состояния: "); Serial.println(model->num_states);
+    Serial.print("Макс. расхождение оценок с полной моделью: "); Serial.println(max_diff, 6);
+    Serial.print("Тактов на Invoke(): полное окно "); Serial.print(full_cycles);
+    Serial.print(", шаг "); Serial.println(step_cycles / NUM_FRAMES);
+    if (step_cycles > 0) {
+        Serial.print("Экономия на шаге захвата: x"); Serial.println((float)full_cycles * NUM_FRAMES / step_cycles, 1);
+    }
+#endif
+}
+#endif // ARDUINO
@@ -0,0 +1,64 @@
+#ifndef STREAMING_MODEL_H
+#define STREAMING_MODEL_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <TensorFlowLite_ESP32.h>
+#endif
+// На хосте - дублер интерпретатора из нативного теста (test/tflite_reference)
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "audio_processing.h"
+#include "event_postprocessor.h"
+
+// Потоковый вариант модели (сборка с -DSTREAMING_MODEL, модель - g_streaming_model
+// в model_streaming.h, создается из .tflite так же, как model.h).
+// Свертки экспортированы с внешним состоянием: кольцевые буферы
+// последних кадров каждой свертки - отдельные входы и выходы модели.
+// Раскладка тензоров:
+//   вход 0          - новый кадр признаков [1, NUM_FEATURES, 1, 1], float32
+//   входы 1..K      - состояние сверток перед шагом
+//   выход 0         - оценки классов [1, NUM_CLASSES], float32
+//   выходы 1..K     - состояние после шага (выход i соответствует входу i)
+// Состояние живет в арене интерпретатора; после Invoke() выход i копируется
+// во вход i. Обмен указателями невозможен: планировщик памяти TFLM может
+// отдать область входа промежуточным тензорам после его последнего чтения
+
+const int STREAMING_MAX_STATES = 8;
+
+#ifdef STREAMING_MODEL
+// Кадр, поданный модели, должен совпадать со столбцом окна, на котором она
+// обучена: при WINDOW_MAX столбец зависит от максимума всего окна и известен
+// только после последнего кадра окна
+static_assert(FRAME_FEATURES_FINAL, "Потоковой модели нужны готовые признаки кадра: -DFRONTEND_PCEN или -DFRONTEND_MFCC");
+#endif
+
+struct StreamingModel {
+    tflite::MicroInterpreter* interpreter;
+    TfLiteTensor* frame_input;
+    TfLiteTensor* scores;
+    int num_states;
+    TfLiteTensor* state_in[STREAMING_MAX_STATES];
+    TfLiteTensor* state_out[STREAMING_MAX_STATES];
+};
+
+// Проверка раскладки тензоров после AllocateTensors(). false - модель
+// не потоковая или не совпадает с фронтендом
+bool streamingModelBegin(StreamingModel* model, tflite::MicroInterpreter* interpreter);
+
+// Обнуление состояния (старт и разрыв потока)
+void streamingModelReset(StreamingModel* model);
+
+// Один шаг: нормализованный кадр (столбец спектрограммы) на вход, Invoke(),
+// перенос состояния. Оценки - model->scores->data.f
+TfLiteStatus streamingModelStep(StreamingModel* model, const float* frame);
+
+#ifdef ARDUINO
+// Сверка с полной моделью: обе модели получают одну и ту же тестовую
+// спектрограмму (потоковая - по кадру за шаг после сброса состояния),
+// печатается максимум расхождения оценок и такты на Invoke() каждой модели.
+// Состояние потоковой модели после проверки сбрасывается
+void reportStreamingModelParity(StreamingModel* model, tflite::MicroInterpreter* full_interpreter,
+                                float* spectrogram);
+#endif
+
+#endif // STREAMING_MODEL_H
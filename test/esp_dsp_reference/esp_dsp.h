@@ -0,0 +1,111 @@
+#ifndef ESP_DSP_REFERENCE_H
+#define ESP_DSP_REFERENCE_H
+
+// Эталон функций esp-dsp, которые использует frontend_kernels_espdsp.cpp:
+// те же алгоритмы, что ANSI-версии библиотеки (dsps_*_ansi), с тем же
+// порядком операций. Только для нативных тестов (-DFRONTEND_ESP_DSP_REFERENCE),
+// на ESP32-S3 собирается настоящая библиотека с ассемблерными версиями
+
+#include <stdint.h>
+#include <math.h>
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+#define ESP_ERR_DSP_INVALID_LENGTH 0x70001
+
+// Таблица, заданная dsps_fft2r_init_fc32 (как dsps_fft_w_table_fc32)
+static float* dsps_fft_w_table_fc32 = nullptr;
+static int dsps_fft_w_table_size = 0;
+
+static inline bool dspsPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+static inline esp_err_t dsps_bit_rev_fc32(float* data, int N) {
+    if (!dspsPowerOfTwo(N)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    int j = 0;
+    for (int i = 1; i < N - 1; i++) {
+        int k = N >> 1;
+        while (k <= j) {
+            j -= k;
+            k >>= 1;
+        }
+        j += k;
+        if (i < j) {
+            float re = data[2 * j];
+            float im = data[2 * j + 1];
+            data[2 * j] = data[2 * i];
+            data[2 * j + 1] = data[2 * i + 1];
+            data[2 * i] = re;
+            data[2 * i + 1] = im;
+        }
+    }
+    return ESP_OK;
+}
+
+// Множители w[i] = exp(j 2 pi i / N), i < N/2, в порядке бит-реверса
+static inline esp_err_t dsps_fft2r_init_fc32(float* fft_table_buff, int table_size) {
+    if (fft_table_buff == nullptr || !dspsPowerOfTwo(table_size)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    float e = (float)(M_PI * 2.0 / table_size);
+    for (int i = 0; i < (table_size >> 1); i++) {
+        fft_table_buff[2 * i] = cosf(i * e);
+        fft_table_buff[2 * i + 1] = sinf(i * e);
+    }
+    dsps_fft_w_table_fc32 = fft_table_buff;
+    dsps_fft_w_table_size = table_size;
+    return dsps_bit_rev_fc32(fft_table_buff, table_size >> 1);
+}
+
+// Radix-2 DIF на месте: вход в естественном порядке, выход - в бит-реверсном
+static inline esp_err_t dsps_fft2r_fc32(float* data, int N) {
+    if (!dspsPowerOfTwo(N) || N > dsps_fft_w_table_size) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    const float* w = dsps_fft_w_table_fc32;
+    int ie = 1;
+    for (int N2 = N / 2; N2 > 0; N2 >>= 1) {
+        int ia = 0;
+        for (int j = 0; j < ie; j++) {
+            float c = w[2 * j];
+            float s = w[2 * j + 1];
+            for (int i = 0; i < N2; i++) {
+                int m = ia + N2;
+                float re_temp = c * data[2 * m] + s * data[2 * m + 1];
+                float im_temp = c * data[2 * m + 1] - s * data[2 * m];
+                data[2 * m] = data[2 * ia] - re_temp;
+                data[2 * m + 1] = data[2 * ia + 1] - im_temp;
+                data[2 * ia] = data[2 * ia] + re_temp;
+                data[2 * ia + 1] = data[2 * ia + 1] + im_temp;
+                ia++;
+            }
+            ia += N2;
+        }
+        ie <<= 1;
+    }
+    return ESP_OK;
+}
+
+static inline esp_err_t dsps_mul_f32(const float* input1, const float* input2, float* output, int len,
+                                     int step1, int step2, int step_out) {
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input1[i * step1] * input2[i * step2];
+    }
+    return ESP_OK;
+}
+
+static inline esp_err_t dsps_dotprod_f32(const float* src1, const float* src2, float* dest, int len) {
+    float acc = 0;
+    for (int i = 0; i < len; i++) {
+        acc += src1[i] * src2[i];
+    }
+    *dest = acc;
+    return ESP_OK;
+}
+
+#endif // ESP_DSP_REFERENCE_H
@@ -0,0 +1,95 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "frontend_kernels.h"
+
+// Точность быстрого log2 (FastLog2Table) относительно log2 в double на всем
+// диапазоне мель-энергий, где работает логарифмическая шкала и MFCC
+
+const int TEST_VALUES = 1 << 21;
+const double TEST_MIN_EXPONENT = -40;
+const double TEST_MAX_EXPONENT = 20;
+const int TEST_MAX_BACKENDS = 4;
+
+// Ошибка полинома и таблицы сверх округления результата до float
+const double FAST_LOG2_KERNEL_ERROR = 2.5e-7;
+
+static float s_values[TEST_VALUES];
+static float s_result[TEST_VALUES];
+
+// Равномерно по показателю 2^-40 .. 2^20
+static void fillRange() {
+    for (int i = 0; i < TEST_VALUES; i++) {
+        double exponent = TEST_MIN_EXPONENT + (TEST_MAX_EXPONENT - TEST_MIN_EXPONENT) * i / (TEST_VALUES - 1);
+        s_values[i] = (float)exp2(exponent);
+    }
+}
+
+static void runKernel(const FrontendBackend* backend) {
+    memcpy(s_result, s_values, sizeof(s_result));
+    backend->log2(s_result, TEST_VALUES);
+}
+
+// Половина шага float около значения: ошибка округления любого log2 в float
+static double halfUlp(double value) {
+    float rounded = fabsf((float)value);
+    return 0.5 * (nextafterf(rounded, INFINITY) - rounded);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_error_in_unit_interval() {
+    for (int i = 0; i < TEST_VALUES; i++) {
+        s_values[i] = 1.0f + (float)i / TEST_VALUES;
+    }
+    runKernel(&kScalarFrontendBackend);
+    double max_error = 0;
+    for (int i = 0; i < TEST_VALUES; i++) {
+        double error = fabs(s_result[i] - log2((double)s_values[i]));
+        max_error = error > max_error ? error : max_error;
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(FAST_LOG2_KERNEL_ERROR, max_error);
+}
+
+static void test_error_over_feature_range() {
+    fillRange();
+    runKernel(&kScalarFrontendBackend);
+    double max_error = 0;
+    double max_libm_error = 0;
+    double max_excess = 0;
+    for (int i = 0; i < TEST_VALUES; i++) {
+        double reference = log2((double)s_values[i]);
+        double error = fabs(s_result[i] - reference);
+        double libm_error = fabs(log2f(s_values[i]) - reference);
+        double excess = error - halfUlp(reference);
+        max_error = error > max_error ? error : max_error;
+        max_libm_error = libm_error > max_libm_error ? libm_error : max_libm_error;
+        max_excess = excess > max_excess ? excess : max_excess;
+    }
+    // Вдали от [1, 2) ошибка - в основном округление результата (шаг float
+    // у 40 - 3.8e-6), поэтому абсолютная ошибка сравнима с log2f
+    TEST_ASSERT_LESS_THAN_FLOAT(FAST_LOG2_KERNEL_ERROR, max_excess);
+    TEST_ASSERT_LESS_THAN_FLOAT(max_libm_error + FAST_LOG2_KERNEL_ERROR, max_error);
+}
+
+static void test_backends_bit_identical() {
+    fillRange();
+    runKernel(&kScalarFrontendBackend);
+    static float scalar[TEST_VALUES];
+    memcpy(scalar, s_result, sizeof(scalar));
+    const FrontendBackend* backends[TEST_MAX_BACKENDS];
+    int count = availableFrontendBackends(backends, TEST_MAX_BACKENDS);
+    for (int i = 0; i < count; i++) {
+        runKernel(backends[i]);
+        TEST_ASSERT_EQUAL_MEMORY(scalar, s_result, sizeof(scalar));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_error_in_unit_interval);
+    RUN_TEST(test_error_over_feature_range);
+    RUN_TEST(test_backends_bit_identical);
+    return UNITY_END();
+}
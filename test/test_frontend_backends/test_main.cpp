@@ -0,0 +1,107 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "audio_processing.h"
+#include "frontend_kernels.h"
+
+// Бэкенды фронтенда на одном кадре: скалярный FFT против ДПФ в double,
+// хостовые векторные бэкенды побитово со скалярным, esp-dsp (эталонные
+// ANSI-версии функций, test/esp_dsp_reference) - с точностью округления
+
+const int TEST_MAX_BACKENDS = 4;
+const float ESPDSP_MAX_RELATIVE_ERROR = 1e-6f;
+
+static FrontendWorkspace s_workspace;
+
+// Две синусоиды и псевдослучайный шум, как в frontend_check.cpp
+static void fillTestFrame(float* frame) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((int32_t)(seed >> 16) - 32768) / 327680.0f;
+        frame[i] = 0.3f * sinf(0.07f * i) + 0.1f * sinf(1.3f * i) + noise;
+    }
+}
+
+static void melFrame(const FrontendBackend* backend, float* mel_energies) {
+    setFrontendBackend(backend);
+    fillTestFrame(s_workspace.fft_buffer);
+    computeMelFrame(&s_workspace);
+    memcpy(mel_energies, s_workspace.mel_energies, NUM_MELS * sizeof(float));
+}
+
+static float maxRelativeError(const float* reference, const float* values, int size) {
+    float peak = 0;
+    float error = 0;
+    for (int i = 0; i < size; i++) {
+        peak = fabsf(reference[i]) > peak ? fabsf(reference[i]) : peak;
+        float diff = fabsf(values[i] - reference[i]);
+        error = diff > error ? diff : error;
+    }
+    return peak > 0 ? error / peak : error;
+}
+
+void setUp() {
+    initFrontend();
+}
+
+void tearDown() {}
+
+static void test_scalar_fft_matches_dft() {
+    setFrontendBackend(&kScalarFrontendBackend);
+    float frame[FFT_SIZE];
+    fillTestFrame(frame);
+    applyHannWindow(frame, s_workspace.fft_data);
+    double windowed[FFT_SIZE];
+    for (int i = 0; i < FFT_SIZE; i++) {
+        windowed[i] = s_workspace.fft_data[2 * i];
+    }
+    computeFFT(s_workspace.fft_data, s_workspace.fft_buffer);
+
+    float reference[FFT_SIZE / 2];
+    for (int k = 0; k < FFT_SIZE / 2; k++) {
+        double re = 0;
+        double im = 0;
+        for (int n = 0; n < FFT_SIZE; n++) {
+            double phase = -2.0 * M_PI * k * n / FFT_SIZE;
+            re += windowed[n] * cos(phase);
+            im += windowed[n] * sin(phase);
+        }
+        reference[k] = (float)sqrt(re * re + im * im);
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(1e-6f, maxRelativeError(reference, s_workspace.fft_buffer, FFT_SIZE / 2));
+}
+
+static void test_host_backends_bit_identical() {
+    float scalar[NUM_MELS];
+    melFrame(&kScalarFrontendBackend, scalar);
+    const FrontendBackend* backends[TEST_MAX_BACKENDS];
+    int count = availableFrontendBackends(backends, TEST_MAX_BACKENDS);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(backends[i]->name, "esp-dsp") == 0) {
+            continue;
+        }
+        float mel[NUM_MELS];
+        melFrame(backends[i], mel);
+        TEST_ASSERT_EQUAL_MEMORY(scalar, mel, sizeof(mel));
+    }
+}
+
+static void test_espdsp_matches_scalar() {
+    const FrontendBackend* espdsp = findFrontendBackend("esp-dsp");
+    TEST_ASSERT_NOT_NULL(espdsp);
+    float scalar[NUM_MELS];
+    float mel[NUM_MELS];
+    melFrame(&kScalarFrontendBackend, scalar);
+    melFrame(espdsp, mel);
+    TEST_ASSERT_EQUAL_STRING("esp-dsp", frontendBackendName());
+    TEST_ASSERT_LESS_THAN_FLOAT(ESPDSP_MAX_RELATIVE_ERROR, maxRelativeError(scalar, mel, NUM_MELS));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_scalar_fft_matches_dft);
+    RUN_TEST(test_host_backends_bit_identical);
+    RUN_TEST(test_espdsp_matches_scalar);
+    return UNITY_END();
+}
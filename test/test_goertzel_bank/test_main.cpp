@@ -0,0 +1,64 @@
+#include <unity.h>
+#include <math.h>
+#include "goertzel_bank.h"
+
+// Банк Герцеля на синтетическом входе: короткий всплеск в целевом бине
+// и устойчивая ступенька фона в нем же (вентилятор, кондиционер)
+
+const float QUIET_AMPLITUDE = 150.0f;     // фон 5 кГц до ступеньки
+const float LOUD_AMPLITUDE = 1500.0f;     // +20 дБ
+const int STEP_SETTLE_HOPS = 300;         // 3 с: ступенька ушла под порог
+const int BURST_HOPS = 20;
+
+static GoertzelBank s_bank;
+static uint32_t s_phase = 0;
+
+// Тон 5 кГц с шумом заданной амплитуды тона
+static void feedHops(float amplitude, int hops) {
+    int16_t hop[HOP_LENGTH];
+    for (int h = 0; h < hops; h++) {
+        for (int i = 0; i < HOP_LENGTH; i++, s_phase++) {
+            float noise = (float)((int32_t)((s_phase * 1103515245u + 12345u) >> 16) % 200 - 100);
+            hop[i] = (int16_t)(noise + amplitude * sinf(2.0f * (float)M_PI * 5000.0f * s_phase / SAMPLE_RATE));
+        }
+        goertzelBankUpdate(&s_bank, hop, HOP_LENGTH);
+    }
+}
+
+void setUp() {
+    goertzelBankBegin(&s_bank, GOERTZEL_TARGET_HZ, GOERTZEL_NUM_TARGETS);
+    feedHops(QUIET_AMPLITUDE, 100);
+}
+
+void tearDown() {}
+
+static void test_burst_triggers_and_releases() {
+    feedHops(LOUD_AMPLITUDE, BURST_HOPS);
+    TEST_ASSERT_EQUAL_UINT32(1, s_bank.triggers);
+    TEST_ASSERT_TRUE(goertzelBankActive(s_bank));
+    // Короткое событие фон почти не сдвигает: до конца всплеска уровень
+    // выше порога, повтор снова срабатывает
+    TEST_ASSERT_TRUE(s_bank.above);
+    feedHops(QUIET_AMPLITUDE, GOERTZEL_HOLD_HOPS);
+    TEST_ASSERT_FALSE(goertzelBankActive(s_bank));
+    feedHops(LOUD_AMPLITUDE, BURST_HOPS);
+    TEST_ASSERT_EQUAL_UINT32(2, s_bank.triggers);
+}
+
+static void test_level_step_releases_gate() {
+    feedHops(LOUD_AMPLITUDE, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, s_bank.triggers);
+    feedHops(LOUD_AMPLITUDE, STEP_SETTLE_HOPS);
+    TEST_ASSERT_FALSE(goertzelBankActive(s_bank));
+    TEST_ASSERT_EQUAL_UINT32(1, s_bank.triggers);
+    // Новый фон: всплеск над ним снова срабатывает
+    feedHops(10.0f * LOUD_AMPLITUDE, BURST_HOPS);
+    TEST_ASSERT_EQUAL_UINT32(2, s_bank.triggers);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_burst_triggers_and_releases);
+    RUN_TEST(test_level_step_releases_gate);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "model_image.h"
+
+// Образ модели от tools/pack_model.py: отображение файла, проверка
+// заголовка и CRC. Модель - минимальный flatbuffer с версией схемы
+// и тремя кодами операций (один повторяется), за ним "веса"
+
+const int32_t OP_FULLY_CONNECTED = 9;
+const int32_t OP_SOFTMAX = 25;
+const uint32_t IMAGE_VERSION = 7;
+const int TINY_MODEL_SIZE = 96;
+const int WEIGHTS_OFFSET = 88;
+
+static uint8_t s_model[TINY_MODEL_SIZE];
+static uint8_t s_image[MODEL_IMAGE_DATA_OFFSET + TINY_MODEL_SIZE];
+static size_t s_image_size = 0;
+static char s_model_path[64];
+static char s_image_path[64];
+
+static void put16(int offset, uint16_t value) { memcpy(s_model + offset, &value, sizeof(value)); }
+static void put32(int offset, uint32_t value) { memcpy(s_model + offset, &value, sizeof(value)); }
+
+// Раскладка: корень -> Model (vtable 4, таблица 12), operator_codes -
+// вектор на 24, OperatorCode (vtable 40, таблицы 52/64/76)
+static void buildTinyModel() {
+    memset(s_model, 0, sizeof(s_model));
+    put32(0, 12);
+    put16(4, 8); put16(6, 12); put16(8, 4); put16(10, 8);
+    put32(12, 12 - 4);
+    put32(16, TFLITE_SCHEMA_VERSION);
+    put32(20, 24 - 20);
+    put32(24, 3);
+    const int32_t codes[3] = {OP_FULLY_CONNECTED, OP_SOFTMAX, OP_FULLY_CONNECTED};
+    put16(40, 12); put16(42, 12); put16(44, 4); put16(46, 0); put16(48, 0); put16(50, 8);
+    for (int i = 0; i < 3; i++) {
+        int table = 52 + 12 * i;
+        put32(28 + 4 * i, table - (28 + 4 * i));
+        put32(table, table - 40);
+        s_model[table + 4] = (uint8_t)codes[i];  // deprecated_builtin_code
+        put32(table + 8, codes[i]);              // builtin_code
+    }
+    for (int i = WEIGHTS_OFFSET; i < TINY_MODEL_SIZE; i++) {
+        s_model[i] = (uint8_t)(i * 37);
+    }
+}
+
+static void writeFile(const char* path, const uint8_t* data, size_t size) {
+    FILE* f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL(size, fwrite(data, 1, size, f));
+    fclose(f);
+}
+
+void setUp() {
+    buildTinyModel();
+    snprintf(s_model_path, sizeof(s_model_path), "/tmp/model_image_%d.tflite", (int)getpid());
+    snprintf(s_image_path, sizeof(s_image_path), "/tmp/model_image_%d.bin", (int)getpid());
+    writeFile(s_model_path, s_model, sizeof(s_model));
+
+    char command[256];
+    snprintf(command, sizeof(command), "python3 tools/pack_model.py %s %s --version %u > /dev/null",
+             s_model_path, s_image_path, (unsigned)IMAGE_VERSION);
+    TEST_ASSERT_EQUAL(0, system(command));
+    FILE* f = fopen(s_image_path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    s_image_size = fread(s_image, 1, sizeof(s_image), f);
+    fclose(f);
+    TEST_ASSERT_EQUAL(sizeof(s_image), s_image_size);
+}
+
+void tearDown() {
+    remove(s_model_path);
+    remove(s_image_path);
+}
+
+static void test_packed_image_maps() {
+    MappedModel mapped = {};
+    TEST_ASSERT_TRUE(modelFileMap(s_image_path, &mapped));
+    TEST_ASSERT_EQUAL_UINT32(IMAGE_VERSION, mapped.header->model_version);
+    TEST_ASSERT_EQUAL_UINT32(TINY_MODEL_SIZE, mapped.header->model_size);
+    TEST_ASSERT_EQUAL(2, mapped.header->num_ops);
+    TEST_ASSERT_EQUAL_INT32(OP_FULLY_CONNECTED, mapped.header->ops[0]);
+    TEST_ASSERT_EQUAL_INT32(OP_SOFTMAX, mapped.header->ops[1]);
+    TEST_ASSERT_TRUE(mapped.model_data == (const uint8_t*)mapped.map_base + MODEL_IMAGE_DATA_OFFSET);
+    TEST_ASSERT_EQUAL(0, memcmp(mapped.model_data, s_model, TINY_MODEL_SIZE));
+
+    modelImageUnmap(&mapped);
+    TEST_ASSERT_NULL(mapped.map_base);
+    TEST_ASSERT_NULL(mapped.header);
+    TEST_ASSERT_NULL(mapped.model_data);
+}
+
+static void test_corrupted_weights_fail_crc() {
+    MappedModel mapped = {};
+    TEST_ASSERT_TRUE(modelImageValidate(s_image, s_image_size, &mapped));
+
+    // Заголовок цел, веса повреждены: ловит только CRC модели
+    s_image[MODEL_IMAGE_DATA_OFFSET + WEIGHTS_OFFSET] ^= 0x01;
+    TEST_ASSERT_FALSE(modelImageValidate(s_image, s_image_size, &mapped));
+    writeFile(s_image_path, s_image, s_image_size);
+    MappedModel from_file = {};
+    TEST_ASSERT_FALSE(modelFileMap(s_image_path, &from_file));
+    TEST_ASSERT_NULL(from_file.map_base);
+}
+
+static void test_damaged_header_rejected() {
+    MappedModel mapped = {};
+    // Версия изменена без пересчета CRC заголовка
+    s_image[offsetof(ModelImageHeader, model_version)] ^= 0x01;
+    TEST_ASSERT_FALSE(modelImageValidate(s_image, s_image_size, &mapped));
+    s_image[offsetof(ModelImageHeader, model_version)] ^= 0x01;
+
+    // Образ обрезан: модель не помещается в отображенную память
+    TEST_ASSERT_FALSE(modelImageValidate(s_image, s_image_size - 1, &mapped));
+    TEST_ASSERT_FALSE(modelImageValidate(s_image, MODEL_IMAGE_DATA_OFFSET - 1, &mapped));
+    TEST_ASSERT_TRUE(modelImageValidate(s_image, s_image_size, &mapped));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_packed_image_maps);
+    RUN_TEST(test_corrupted_weights_fail_crc);
+    RUN_TEST(test_damaged_header_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <pthread.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc_tracker.h"
+#include "audio_processing.h"
+#include "signal_stats.h"
+#include "goertzel_bank.h"
+#include "onset_detector.h"
+#include "inference_scheduler.h"
+#include "event_postprocessor.h"
+
+// Установившийся режим конвейера на хосте: те же функции, что loop() на
+// каждом шаге захвата, в потоке с собственным окрашиваемым стеком.
+// Окно - шаги до очередного инференса (NUM_FRAMES шагов), как в loop()
+
+const int TEST_RING_HOPS = 52;
+const int TEST_RING_SIZE = TEST_RING_HOPS * HOP_LENGTH;
+const int TEST_WINDOWS = 6;
+const size_t TEST_THREAD_STACK = 64 * 1024;
+
+static int16_t s_ring[TEST_RING_SIZE];
+static FrontendWorkspace s_workspace;
+static float s_spectrogram[MEL_SPECTROGRAM_SIZE];
+static SignalConditioner s_conditioner;
+static GoertzelBank s_goertzel;
+static OnsetDetector s_onset;
+static InferenceScheduler s_scheduler;
+static EventPostprocessor s_postprocessor;
+static EventRecord s_records[EVENT_MAX_RECORDS];
+static uint32_t s_hop = 0;
+static uint32_t s_phase = 0;
+
+alignas(16) static uint8_t s_thread_stack[TEST_THREAD_STACK];
+alignas(16) static uint8_t s_probe_stack[TEST_THREAD_STACK];
+
+struct ThreadJob {
+    uint8_t* stack;
+    uint32_t budget;
+    void (*body)();
+    uint32_t max_used;
+};
+
+// Шум с редкими щелчками 5 кГц: срабатывают и банк Герцеля, и онсеты
+static void synthesizeHop(int16_t* hop) {
+    for (int i = 0; i < HOP_LENGTH; i++, s_phase++) {
+        float noise = (float)((int32_t)((s_phase * 1103515245u + 12345u) >> 16) % 200 - 100);
+        bool click = (s_phase / HOP_LENGTH) % 75 < 3;
+        float tone = click ? 8000.0f * sinf(2.0f * (float)M_PI * 5000.0f * s_phase / SAMPLE_RATE) : 0.0f;
+        hop[i] = (int16_t)(noise + tone);
+    }
+}
+
+static void pipelineHop() {
+    int offset = (int)(s_hop % TEST_RING_HOPS) * HOP_LENGTH;
+    int16_t* hop = s_ring + offset;
+    synthesizeHop(hop);
+    Int16Stats stats;
+    resetStats(&stats);
+    conditionSamplesWithStats(&s_conditioner, hop, HOP_LENGTH, 1000, &stats);
+    goertzelBankUpdate(&s_goertzel, hop, HOP_LENGTH);
+    s_hop++;
+
+    int tail = (int)((s_hop * HOP_LENGTH + TEST_RING_SIZE - FFT_SIZE) % TEST_RING_SIZE);
+    loadFrame(s_ring, TEST_RING_SIZE, tail, s_workspace.fft_buffer);
+    computeStreamMelFrame(&s_workspace);
+    onsetDetectorUpdate(&s_onset, s_workspace.mel_energies);
+    inferenceSchedulerUpdate(&s_scheduler, s_workspace.mel_energies);
+    eventPostprocessorTick(&s_postprocessor, s_hop, s_records);
+}
+
+static void pipelineWindow() {
+    allocTrackerWindowBegin();
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        pipelineHop();
+    }
+    int start = (int)((s_hop * HOP_LENGTH + TEST_RING_SIZE - WINDOW_SAMPLES) % TEST_RING_SIZE);
+    FloatStats stats;
+    resetStats(&stats);
+    audioToMelSpectrogram(s_ring, TEST_RING_SIZE, start, s_spectrogram, &s_workspace, &stats);
+    float scores[NUM_CLASSES] = {s_spectrogram[0], 0.5f, 0.0f};
+    eventPostprocessorUpdate(&s_postprocessor, scores, s_hop, s_records);
+    allocTrackerWindowEnd();
+}
+
+static void* threadEntry(void* arg) {
+    ThreadJob* job = (ThreadJob*)arg;
+    // Вершина - кадр входа в поток: служебные данные потока выше не считаются
+    uint8_t* top = (uint8_t*)__builtin_frame_address(0);
+    stackBudgetRegister("test", job->stack, (uint32_t)(top - job->stack), job->budget);
+    job->body();
+    job->max_used = stackBudgetMaxUsed();
+    stackBudgetUnregisterCurrentTask();
+    return nullptr;
+}
+
+static uint32_t runOnStack(uint8_t* stack, uint32_t budget, void (*body)()) {
+    ThreadJob job = {stack, budget, body, 0};
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, TEST_THREAD_STACK);
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, &attr, threadEntry, &job));
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+    return job.max_used;
+}
+
+static void runPipeline() {
+    for (int window = 0; window < TEST_WINDOWS; window++) {
+        pipelineWindow();
+    }
+}
+
+static void heapInWindow() {
+    allocTrackerWindowBegin();
+    void* volatile block = malloc(64);
+    free(block);
+    allocTrackerWindowEnd();
+}
+
+static void deepStack() {
+    stackBudgetBegin();
+    volatile uint8_t buffer[2048];
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)i;
+    }
+    stackBudgetEnd();
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_pipeline_within_budget() {
+    initFrontend();
+    initConditioner(&s_conditioner, 0.995f, 0.0f, 1.0f);
+    goertzelBankBegin(&s_goertzel, GOERTZEL_TARGET_HZ, GOERTZEL_NUM_TARGETS);
+    resetOnsetDetector(&s_onset);
+    resetInferenceScheduler(&s_scheduler);
+    resetEventPostprocessor(&s_postprocessor);
+
+    uint32_t violations = allocTrackerViolations();
+    uint32_t used = runOnStack(s_thread_stack, PIPELINE_STACK_BUDGET, runPipeline);
+    TEST_ASSERT_EQUAL_UINT32(violations, allocTrackerViolations());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, used);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(PIPELINE_STACK_BUDGET, used);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, s_goertzel.triggers);
+}
+
+static void test_heap_in_window_is_violation() {
+    // Окна прогрева уже пройдены предыдущим тестом
+    uint32_t violations = allocTrackerViolations();
+    runOnStack(s_thread_stack, PIPELINE_STACK_BUDGET, heapInWindow);
+    TEST_ASSERT_EQUAL_UINT32(violations + 1, allocTrackerViolations());
+}
+
+static void test_stack_over_budget_is_violation() {
+    uint32_t violations = allocTrackerViolations();
+    uint32_t used = runOnStack(s_probe_stack, 1024, deepStack);
+    TEST_ASSERT_GREATER_THAN_UINT32(2048, used);
+    TEST_ASSERT_EQUAL_UINT32(violations + 1, allocTrackerViolations());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pipeline_within_budget);
+    RUN_TEST(test_heap_in_window_is_violation);
+    RUN_TEST(test_stack_over_budget_is_violation);
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "resampler.h"
+#include "audio_processing.h"
+#include "frontend_kernels.h"
+
+// Ресемплер на 44.1 и 48 кГц -> SAMPLE_RATE: векторное ядро хоста бит в бит
+// со скалярным, АЧХ в полосе пропускания и подавление в полосе
+// задерживания (то, что иначе отразится в полосу фронтенда), одинаковый
+// выход при подаче потока одним куском и кусками произвольной длины
+
+const int TEST_RATES[] = {44100, 48000};
+const int TEST_INPUT_SAMPLES = 48000;          // 1 с на 48 кГц
+const int TEST_OUTPUT_CAPACITY = TEST_INPUT_SAMPLES;
+const int SETTLE_OUTPUTS = 64;                 // больше задержки фильтра
+const float TONE_AMPLITUDE = 16000.0f;
+const float PASSBAND_MAX_DB = 0.1f;
+const float STOPBAND_MIN_DB = 50.0f;            // окно Кайзера beta = 6: ~55..60 дБ
+const int COEFFS_CAPACITY = 160 * 96;          // 44.1 кГц: 160 фаз по 96 отводов
+
+static int16_t s_coeffs[COEFFS_CAPACITY];
+static int16_t s_reference_coeffs[COEFFS_CAPACITY];
+static Resampler s_rs;
+static Resampler s_reference;
+static int16_t s_input[TEST_INPUT_SAMPLES];
+static int16_t s_output[TEST_OUTPUT_CAPACITY];
+static int16_t s_reference_output[TEST_OUTPUT_CAPACITY];
+
+static void fillTone(float hz, int in_rate) {
+    for (int i = 0; i < TEST_INPUT_SAMPLES; i++) {
+        s_input[i] = (int16_t)lrintf(TONE_AMPLITUDE * sinf(2.0f * (float)M_PI * hz * i / in_rate));
+    }
+}
+
+// Два тона и шум почти на всю шкалу: насыщение и округление тоже сверяются
+static void fillMixture() {
+    uint32_t seed = 12345;
+    for (int i = 0; i < TEST_INPUT_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((int32_t)(seed >> 16) - 32768) * 0.3f;
+        float value = 14000.0f * sinf(0.05f * i) + 8000.0f * sinf(2.9f * i) + noise;
+        s_input[i] = (int16_t)fmaxf(-32768.0f, fminf(32767.0f, value));
+    }
+}
+
+static int processAll(Resampler* rs, int16_t* out) {
+    int consumed = 0;
+    int produced = resamplerProcess(rs, s_input, TEST_INPUT_SAMPLES, &consumed, out, TEST_OUTPUT_CAPACITY);
+    TEST_ASSERT_EQUAL(TEST_INPUT_SAMPLES, consumed);
+    return produced;
+}
+
+// Амплитуда тона на выходе после установления фильтра
+static float outputAmplitude(int produced) {
+    double energy = 0;
+    for (int i = SETTLE_OUTPUTS; i < produced; i++) {
+        energy += (double)s_output[i] * s_output[i];
+    }
+    return (float)sqrt(2.0 * energy / (produced - SETTLE_OUTPUTS));
+}
+
+static float toneGainDb(int in_rate, float hz) {
+    fillTone(hz, in_rate);
+    resamplerReset(&s_rs);
+    int produced = processAll(&s_rs, s_output);
+    return 20.0f * log10f(fmaxf(outputAmplitude(produced), 1e-3f) / TONE_AMPLITUDE);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_vector_kernel_matches_scalar() {
+    fillMixture();
+    for (int in_rate : TEST_RATES) {
+        TEST_ASSERT_TRUE(resamplerInit(&s_rs, in_rate, SAMPLE_RATE, s_coeffs, COEFFS_CAPACITY));
+        TEST_ASSERT_TRUE(resamplerInit(&s_reference, in_rate, SAMPLE_RATE, s_reference_coeffs, COEFFS_CAPACITY));
+        resamplerUseScalarKernel(&s_reference);
+#ifdef FRONTEND_HAS_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            TEST_ASSERT_EQUAL_STRING("avx2", s_rs.kernel_name);
+        }
+#endif
+        int produced = processAll(&s_rs, s_output);
+        TEST_ASSERT_EQUAL(produced, processAll(&s_reference, s_reference_output));
+        TEST_ASSERT_GREATER_THAN(TEST_INPUT_SAMPLES * SAMPLE_RATE / in_rate - 2, produced);
+        TEST_ASSERT_EQUAL(0, memcmp(s_output, s_reference_output, produced * sizeof(int16_t)));
+    }
+}
+
+static void test_passband_and_stopband() {
+    const float passband_hz[] = {300.0f, 1000.0f, 4000.0f, 6000.0f};
+    // Выше половины SAMPLE_RATE: без фильтра отразились бы в 0..8 кГц
+    const float stopband_hz[] = {8500.0f, 10000.0f, 15000.0f, 20000.0f};
+    for (int in_rate : TEST_RATES) {
+        TEST_ASSERT_TRUE(resamplerInit(&s_rs, in_rate, SAMPLE_RATE, s_coeffs, COEFFS_CAPACITY));
+        for (float hz : passband_hz) {
+            TEST_ASSERT_LESS_THAN_FLOAT(PASSBAND_MAX_DB, fabsf(toneGainDb(in_rate, hz)));
+        }
+        for (float hz : stopband_hz) {
+            TEST_ASSERT_LESS_THAN_FLOAT(-STOPBAND_MIN_DB, toneGainDb(in_rate, hz));
+        }
+    }
+}
+
+static void test_chunked_stream_matches_single_call() {
+    fillMixture();
+    for (int in_rate : TEST_RATES) {
+        TEST_ASSERT_TRUE(resamplerInit(&s_rs, in_rate, SAMPLE_RATE, s_coeffs, COEFFS_CAPACITY));
+        int expected = processAll(&s_rs, s_reference_output);
+
+        // Куски входа разной длины и маленький выходной буфер: вызов
+        // прерывается по out_capacity, остаток входа подается снова
+        resamplerReset(&s_rs);
+        const int chunks[] = {1, 7, 160, 441, 33, 1000};
+        const int out_capacity = 5;
+        int position = 0;
+        int produced = 0;
+        for (int k = 0; position < TEST_INPUT_SAMPLES; k++) {
+            int count = chunks[k % 6];
+            count = count < TEST_INPUT_SAMPLES - position ? count : TEST_INPUT_SAMPLES - position;
+            int end = position + count;
+            while (position < end) {
+                int consumed = 0;
+                produced += resamplerProcess(&s_rs, s_input + position, end - position, &consumed,
+                                             s_output + produced, out_capacity);
+                position += consumed;
+            }
+        }
+        // Выходы, для которых вход уже есть, но не уместились в последний вызов
+        int consumed = 0;
+        int tail = 0;
+        do {
+            tail = resamplerProcess(&s_rs, s_input, 0, &consumed, s_output + produced, out_capacity);
+            produced += tail;
+        } while (tail > 0);
+        TEST_ASSERT_EQUAL(expected, produced);
+        TEST_ASSERT_EQUAL(0, memcmp(s_output, s_reference_output, produced * sizeof(int16_t)));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_vector_kernel_matches_scalar);
+    RUN_TEST(test_passband_and_stopband);
+    RUN_TEST(test_chunked_stream_matches_single_call);
+    return UNITY_END();
+}
@@ -0,0 +1,289 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "audio_processing.h"
+#include "audio_capture.h"
+#include "mel_stream.h"
+#include "streaming_model.h"
+
+// Потоковая модель против оконной на одном и том же потоке. Кадры идут
+// через код прошивки: шаг захвата (captureHostHop) -> melStreamPushHop ->
+// melStreamLastFrame на вход потоковой модели, окно - melStreamToSpectrogram
+// по последним NUM_FRAMES кадрам. Сборка с -DFRONTEND_PCEN -DSTREAMING_MODEL
+// (env:native_streaming): при WINDOW_MAX кадр не окончателен, пока он в окне.
+// TFLM на хосте нет, поэтому обе модели - эталонная сеть теста в двух
+// экспортах с общими весами (дублер интерпретатора, test/tflite_reference):
+//   окно - вход [NUM_FEATURES x NUM_FRAMES], свертки без дополнения (valid),
+//          среднее по VALID_FRAMES выходам, у которых все входы в окне;
+//   поток - кадр и состояние, как описано в streaming_model.h; среднее -
+//          скользящее по последним VALID_FRAMES выходам (они в состоянии).
+// Сеть: каузальная свертка 3 кадра -> ReLU -> свертка 3 кадра с прореживанием
+// 2 -> ReLU -> среднее -> полносвязный слой -> сигмоида.
+// С этим экспортом после прогрева потока каждый шаг совпадает с окном по
+// тем же кадрам, сколько бы шагов ни прошло. Проверяется код прошивки:
+// кольцо кадров, раскладка (streamingModelBegin), перенос и сброс состояния
+// (streamingModelStep, streamingModelReset)
+
+const int C1 = 8;
+const int C2 = 8;
+const int K = 3;
+const int DILATION2 = 2;
+const int HISTORY1 = K - 1;                     // кадров входа в состоянии 1
+const int HISTORY2 = (K - 1) * DILATION2;       // кадров слоя 1 в состоянии 2
+const int VALID_FRAMES = NUM_FRAMES - HISTORY1 - HISTORY2;  // выходов слоя 2 в среднем
+const int HISTORY_POOL = VALID_FRAMES - 1;      // выходов слоя 2 в состоянии 3
+const int STREAM_HOPS = 3 * NUM_FRAMES;
+const int TONE_ONSET_HOP = 2 * NUM_FRAMES;      // тон входит в окно уже после прогрева
+const float PARITY_TOLERANCE = 1e-6f;
+
+static_assert(FRAME_FEATURES_FINAL, "test_streaming_parity собирается в env:native_streaming");
+
+static float w1[C1][K][NUM_FEATURES], b1[C1];
+static float w2[C2][K][C1], b2[C2];
+static float wd[NUM_CLASSES][C2], bd[NUM_CLASSES];
+
+static void initWeights() {
+    uint32_t seed = 2024;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return ((int32_t)(seed >> 8) - (1 << 23)) / (float)(1 << 23);
+    };
+    for (auto& c : w1) for (auto& k : c) for (float& w : k) w = 0.3f * next();
+    for (auto& c : w2) for (auto& k : c) for (float& w : k) w = 0.4f * next();
+    for (auto& c : wd) for (float& w : c) w = next();
+    for (float& b : b1) b = 0.1f * next();
+    for (float& b : b2) b = 0.1f * next();
+    for (float& b : bd) b = 0.1f * next();
+}
+
+// Слои на один кадр, общие для обоих экспортов: taps[k] - кадр t - (K-1-k)*d
+static void conv1Frame(const float* const taps[K], float* out) {
+    for (int c = 0; c < C1; c++) {
+        float sum = b1[c];
+        for (int k = 0; k < K; k++) {
+            for (int f = 0; f < NUM_FEATURES; f++) {
+                sum += w1[c][k][f] * taps[k][f];
+            }
+        }
+        out[c] = sum > 0 ? sum : 0;
+    }
+}
+
+static void conv2Frame(const float* const taps[K], float* out) {
+    for (int c = 0; c < C2; c++) {
+        float sum = b2[c];
+        for (int k = 0; k < K; k++) {
+            for (int i = 0; i < C1; i++) {
+                sum += w2[c][k][i] * taps[k][i];
+            }
+        }
+        out[c] = sum > 0 ? sum : 0;
+    }
+}
+
+static void denseScores(const float* pool_sum, float* scores) {
+    for (int j = 0; j < NUM_CLASSES; j++) {
+        float sum = bd[j];
+        for (int c = 0; c < C2; c++) {
+            sum += wd[j][c] * (pool_sum[c] / VALID_FRAMES);
+        }
+        scores[j] = 1.0f / (1.0f + expf(-sum));
+    }
+}
+
+// Оконный экспорт
+static float s_window_input[SPECTROGRAM_SIZE];
+static float s_window_scores[NUM_CLASSES];
+
+static TfLiteStatus invokeWindow(tflite::MicroInterpreter*) {
+    static float x[NUM_FRAMES][NUM_FEATURES];
+    static float y1[NUM_FRAMES][C1];
+    for (int t = 0; t < NUM_FRAMES; t++) {
+        for (int f = 0; f < NUM_FEATURES; f++) {
+            x[t][f] = s_window_input[f * NUM_FRAMES + t];
+        }
+    }
+    for (int t = HISTORY1; t < NUM_FRAMES; t++) {
+        const float* taps1[K] = {x[t - 2], x[t - 1], x[t]};
+        conv1Frame(taps1, y1[t]);
+    }
+    float pool_sum[C2] = {};
+    for (int t = HISTORY1 + HISTORY2; t < NUM_FRAMES; t++) {
+        const float* taps2[K] = {y1[t - 2 * DILATION2], y1[t - DILATION2], y1[t]};
+        float y2[C2];
+        conv2Frame(taps2, y2);
+        for (int c = 0; c < C2; c++) {
+            pool_sum[c] += y2[c];
+        }
+    }
+    denseScores(pool_sum, s_window_scores);
+    return kTfLiteOk;
+}
+
+// Потоковый экспорт: входы 1..3 - состояние, выходы 1..3 - новое состояние
+static float s_frame[NUM_FEATURES];
+static float s_scores[NUM_CLASSES];
+static float s_state1_in[HISTORY1 * NUM_FEATURES], s_state1_out[HISTORY1 * NUM_FEATURES];
+static float s_state2_in[HISTORY2 * C1], s_state2_out[HISTORY2 * C1];
+static float s_pool_in[HISTORY_POOL * C2], s_pool_out[HISTORY_POOL * C2];
+
+static TfLiteStatus invokeStep(tflite::MicroInterpreter*) {
+    // Состояние - кадры по порядку, самый старый первым
+    const float* taps1[K] = {s_state1_in, s_state1_in + NUM_FEATURES, s_frame};
+    float y1[C1];
+    conv1Frame(taps1, y1);
+    memcpy(s_state1_out, s_state1_in + NUM_FEATURES, (HISTORY1 - 1) * NUM_FEATURES * sizeof(float));
+    memcpy(s_state1_out + (HISTORY1 - 1) * NUM_FEATURES, s_frame, NUM_FEATURES * sizeof(float));
+
+    const float* taps2[K] = {s_state2_in, s_state2_in + DILATION2 * C1, y1};
+    float y2[C2];
+    conv2Frame(taps2, y2);
+    memcpy(s_state2_out, s_state2_in + C1, (HISTORY2 - 1) * C1 * sizeof(float));
+    memcpy(s_state2_out + (HISTORY2 - 1) * C1, y1, C1 * sizeof(float));
+
+    // Сумма в том же порядке, что в окне: от самого старого выхода к новому
+    float pool_sum[C2] = {};
+    for (int t = 0; t < HISTORY_POOL; t++) {
+        for (int c = 0; c < C2; c++) {
+            pool_sum[c] += s_pool_in[t * C2 + c];
+        }
+    }
+    for (int c = 0; c < C2; c++) {
+        pool_sum[c] += y2[c];
+    }
+    memcpy(s_pool_out, s_pool_in + C2, (HISTORY_POOL - 1) * C2 * sizeof(float));
+    memcpy(s_pool_out + (HISTORY_POOL - 1) * C2, y2, C2 * sizeof(float));
+    denseScores(pool_sum, s_scores);
+    return kTfLiteOk;
+}
+
+static tflite::MicroInterpreter s_window_interpreter(invokeWindow);
+static tflite::MicroInterpreter s_step_interpreter(invokeStep);
+static StreamingModel s_streaming;
+
+// Поток захвата: шум и тон с TONE_ONSET_HOP, у каждого потока своя частота
+static FrontendWorkspace s_workspace;
+static uint32_t s_sample = 0;
+
+static void captureSignalHop(float tone_hz, int hop) {
+    int16_t samples[HOP_LENGTH];
+    uint32_t seed = (uint32_t)tone_hz + s_sample;
+    for (int i = 0; i < HOP_LENGTH; i++, s_sample++) {
+        seed = seed * 1103515245u + 12345u;
+        float noise = (float)((int32_t)(seed >> 16) % 600 - 300);
+        float tone = hop >= TONE_ONSET_HOP ? 6000.0f * sinf(2.0f * (float)M_PI * tone_hz * s_sample / SAMPLE_RATE) : 0;
+        samples[i] = (int16_t)(noise + tone);
+    }
+    captureHostHop(samples);
+}
+
+// Сверка с окном по тем же кадрам на каждом шаге, где окно уже собрано
+static float maxScoreDiff() {
+    melStreamToSpectrogram(s_window_input);
+    s_window_interpreter.Invoke();
+    float max_diff = 0;
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        float diff = fabsf(s_window_scores[i] - s_streaming.scores->data.f[i]);
+        max_diff = diff > max_diff ? diff : max_diff;
+    }
+    return max_diff;
+}
+
+// Шаги захвата и потоковой модели, как в loop(); возвращает максимум
+// расхождения по шагам с собранным окном и число таких шагов
+static float streamSignal(float tone_hz, int hops, int* compared) {
+    float max_diff = 0;
+    *compared = 0;
+    for (int hop = 0; hop < hops; hop++) {
+        captureSignalHop(tone_hz, hop);
+        if (melStreamPushHop(&s_workspace) == nullptr) {
+            continue;
+        }
+        float frame[NUM_FEATURES];
+        melStreamLastFrame(frame);
+        TEST_ASSERT_EQUAL(kTfLiteOk, streamingModelStep(&s_streaming, frame));
+        if (melStreamWindowReady()) {
+            float diff = maxScoreDiff();
+            max_diff = diff > max_diff ? diff : max_diff;
+            (*compared)++;
+        }
+    }
+    return max_diff;
+}
+
+// Новый поток кадров, как restartFrames() в main.cpp
+static void restartFrames() {
+    melStreamReset();
+    streamingModelReset(&s_streaming);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_begin_accepts_layout() {
+    initFrontend();
+    initWeights();
+    captureHostBegin();
+    s_window_interpreter.AddInput(s_window_input, SPECTROGRAM_SIZE);
+    s_window_interpreter.AddOutput(s_window_scores, NUM_CLASSES);
+    s_step_interpreter.AddInput(s_frame, NUM_FEATURES);
+    s_step_interpreter.AddInput(s_state1_in, HISTORY1 * NUM_FEATURES);
+    s_step_interpreter.AddInput(s_state2_in, HISTORY2 * C1);
+    s_step_interpreter.AddInput(s_pool_in, HISTORY_POOL * C2);
+    s_step_interpreter.AddOutput(s_scores, NUM_CLASSES);
+    s_step_interpreter.AddOutput(s_state1_out, HISTORY1 * NUM_FEATURES);
+    s_step_interpreter.AddOutput(s_state2_out, HISTORY2 * C1);
+    s_step_interpreter.AddOutput(s_pool_out, HISTORY_POOL * C2);
+    TEST_ASSERT_TRUE(streamingModelBegin(&s_streaming, &s_step_interpreter));
+    TEST_ASSERT_EQUAL(3, s_streaming.num_states);
+}
+
+static void test_begin_rejects_mismatched_state() {
+    float frame[NUM_FEATURES], scores[NUM_CLASSES], state_in[4], state_out[8];
+    tflite::MicroInterpreter interpreter(invokeStep);
+    interpreter.AddInput(frame, NUM_FEATURES);
+    interpreter.AddInput(state_in, 4);
+    interpreter.AddOutput(scores, NUM_CLASSES);
+    interpreter.AddOutput(state_out, 8);
+    StreamingModel model;
+    TEST_ASSERT_FALSE(streamingModelBegin(&model, &interpreter));
+}
+
+static void test_stream_matches_window() {
+    restartFrames();
+    int compared = 0;
+    float max_diff = streamSignal(1000.0f, STREAM_HOPS, &compared);
+    // Окно собирается после прогрева и NUM_FRAMES кадров, дальше - каждый шаг
+    TEST_ASSERT_EQUAL(STREAM_HOPS - (MEL_STREAM_WARMUP_HOPS - 1) - (NUM_FRAMES - 1), compared);
+    TEST_ASSERT_LESS_THAN_FLOAT(PARITY_TOLERANCE, max_diff);
+}
+
+static void test_restart_matches_new_window() {
+    int compared = 0;
+    restartFrames();
+    streamSignal(500.0f, STREAM_HOPS, &compared);
+
+    // Сброс обнуляет состояние
+    restartFrames();
+    for (int i = 0; i < s_streaming.num_states; i++) {
+        const float* state = s_streaming.state_in[i]->data.f;
+        for (size_t j = 0; j < s_streaming.state_in[i]->bytes / sizeof(float); j++) {
+            TEST_ASSERT_EQUAL_FLOAT(0.0f, state[j]);
+        }
+    }
+
+    // Захват не прерывался (простой банка Герцеля): новое окно после
+    // прогрева снова совпадает на каждом шаге
+    float max_diff = streamSignal(3000.0f, STREAM_HOPS, &compared);
+    TEST_ASSERT_GREATER_THAN_INT(NUM_FRAMES, compared);
+    TEST_ASSERT_LESS_THAN_FLOAT(PARITY_TOLERANCE, max_diff);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_accepts_layout);
+    RUN_TEST(test_begin_rejects_mismatched_state);
+    RUN_TEST(test_stream_matches_window);
+    RUN_TEST(test_restart_matches_new_window);
+    return UNITY_END();
+}
@@ -0,0 +1,58 @@
+#ifndef TFLITE_REFERENCE_MICRO_INTERPRETER_H
+#define TFLITE_REFERENCE_MICRO_INTERPRETER_H
+
+// Дублер интерпретатора TFLM для нативных тестов: тензоры с той же
+// раскладкой полей, что использует прошивка (type, bytes, data), и Invoke(),
+// который вызывает эталонную модель теста. На ESP32-S3 собирается настоящий
+// TFLM из TensorFlowLite_ESP32
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum TfLiteStatus { kTfLiteOk = 0, kTfLiteError = 1 };
+enum TfLiteType { kTfLiteNoType = 0, kTfLiteFloat32 = 1 };
+
+struct TfLiteTensor {
+    TfLiteType type;
+    size_t bytes;
+    union {
+        float* f;
+        char* raw;
+    } data;
+};
+
+namespace tflite {
+
+const int REFERENCE_MAX_TENSORS = 8;
+
+class MicroInterpreter {
+public:
+    typedef TfLiteStatus (*InvokeFn)(MicroInterpreter* interpreter);
+
+    explicit MicroInterpreter(InvokeFn invoke) : invoke_(invoke) {}
+
+    // Тензор float32 из памяти buffer (floats значений)
+    void AddInput(float* buffer, int floats) {
+        inputs_[num_inputs_++] = {kTfLiteFloat32, floats * sizeof(float), {buffer}};
+    }
+    void AddOutput(float* buffer, int floats) {
+        outputs_[num_outputs_++] = {kTfLiteFloat32, floats * sizeof(float), {buffer}};
+    }
+
+    size_t inputs_size() const { return num_inputs_; }
+    size_t outputs_size() const { return num_outputs_; }
+    TfLiteTensor* input(size_t index) { return index < (size_t)num_inputs_ ? &inputs_[index] : nullptr; }
+    TfLiteTensor* output(size_t index) { return index < (size_t)num_outputs_ ? &outputs_[index] : nullptr; }
+    TfLiteStatus Invoke() { return invoke_(this); }
+
+private:
+    InvokeFn invoke_;
+    TfLiteTensor inputs_[REFERENCE_MAX_TENSORS] = {};
+    TfLiteTensor outputs_[REFERENCE_MAX_TENSORS] = {};
+    int num_inputs_ = 0;
+    int num_outputs_ = 0;
+};
+
+} // namespace tflite
+
+#endif // TFLITE_REFERENCE_MICRO_INTERPRETER_H
@@ -0,0 +1,86 @@
+#ifndef TFLITE_REFERENCE_SCHEMA_GENERATED_H
+#define TFLITE_REFERENCE_SCHEMA_GENERATED_H
+
+// Дублер схемы TFLite для нативных тестов: чтение тех полей flatbuffer
+// модели, что использует прошивка (Model.version, Model.operator_codes,
+// коды операций), прямо из буфера - как tools/pack_model.py. На ESP32-S3
+// собирается настоящая схема из TensorFlowLite_ESP32
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TFLITE_SCHEMA_VERSION (3)
+
+namespace tflite {
+
+typedef int32_t BuiltinOperator;
+
+namespace reference {
+
+template <typename T>
+inline T readScalar(const uint8_t* p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+// Поле таблицы flatbuffer или nullptr, если поле не записано
+inline const uint8_t* tableField(const uint8_t* table, int field) {
+    const uint8_t* vtable = table - readScalar<int32_t>(table);
+    uint16_t vtable_size = readScalar<uint16_t>(vtable);
+    int slot = 4 + 2 * field;
+    if (slot >= vtable_size) {
+        return nullptr;
+    }
+    uint16_t offset = readScalar<uint16_t>(vtable + slot);
+    return offset != 0 ? table + offset : nullptr;
+}
+
+// Переход по смещению uoffset, записанному в p
+inline const uint8_t* follow(const uint8_t* p) {
+    return p + readScalar<uint32_t>(p);
+}
+
+} // namespace reference
+
+struct OperatorCode {
+    int8_t deprecated_builtin_code() const {
+        const uint8_t* field = reference::tableField((const uint8_t*)this, 0);
+        return field != nullptr ? reference::readScalar<int8_t>(field) : 0;
+    }
+    BuiltinOperator builtin_code() const {
+        const uint8_t* field = reference::tableField((const uint8_t*)this, 3);
+        return field != nullptr ? reference::readScalar<int32_t>(field) : 0;
+    }
+};
+
+// Вектор таблиц: длина, затем смещения элементов
+template <typename T>
+struct Vector {
+    uint32_t size() const {
+        return reference::readScalar<uint32_t>((const uint8_t*)this);
+    }
+    const T* Get(uint32_t i) const {
+        return (const T*)reference::follow((const uint8_t*)this + 4 + 4 * i);
+    }
+};
+
+struct Model {
+    uint32_t version() const {
+        const uint8_t* field = reference::tableField((const uint8_t*)this, 0);
+        return field != nullptr ? reference::readScalar<uint32_t>(field) : 0;
+    }
+    const Vector<OperatorCode>* operator_codes() const {
+        const uint8_t* field = reference::tableField((const uint8_t*)this, 1);
+        return field != nullptr ? (const Vector<OperatorCode>*)reference::follow(field) : nullptr;
+    }
+};
+
+inline const Model* GetModel(const void* buffer) {
+    return (const Model*)reference::follow((const uint8_t*)buffer);
+}
+
+} // namespace tflite
+
+#endif // TFLITE_REFERENCE_SCHEMA_GENERATED_H
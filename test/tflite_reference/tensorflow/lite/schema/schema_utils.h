@@ -0,0 +1,17 @@
+#ifndef TFLITE_REFERENCE_SCHEMA_UTILS_H
+#define TFLITE_REFERENCE_SCHEMA_UTILS_H
+
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Как в TFLite: больший из устаревшего int8 и нового int32 кода
+inline BuiltinOperator GetBuiltinCode(const OperatorCode* op_code) {
+    BuiltinOperator deprecated = op_code->deprecated_builtin_code();
+    BuiltinOperator code = op_code->builtin_code();
+    return code > deprecated ? code : deprecated;
+}
+
+} // namespace tflite
+
+#endif // TFLITE_REFERENCE_SCHEMA_UTILS_H
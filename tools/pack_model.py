@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+# Сборка образа модели для флеш-разделов "model"/"model_b" (формат - src/model_image.h):
+# заголовок с версией, списком операций и CRC-32, затем .tflite со смещения 128.
+#   python tools/pack_model.py model.tflite model.bin --version 3
+#   esptool.py write_flash 0x670000 model.bin    (раздел model_b - 0x730000)
+# esptool перезагружает плату. Замена без перезагрузки (src/model_hot_swap.h):
+# --send передает образ работающей прошивке, она пишет его в резервный раздел
+# (нужен pyserial)
+#   python tools/pack_model.py model.tflite model.bin --version 4 --send /dev/ttyACM0
+import argparse
+import struct
+import sys
+import zlib
+
+MODEL_IMAGE_MAGIC = 0x4C444D53  # "SMDL"
+MODEL_IMAGE_FORMAT = 1
+MODEL_IMAGE_DATA_OFFSET = 128
+MODEL_MAX_OPS = 16
+PARTITION_SIZE = 0xC0000
+FLASH_SECTOR_SIZE = 0x1000
+SEND_TIMEOUT_S = 10  # стирание сектора и запись на устройстве
+
+
+def table_field(buf, table, field):
+    # Смещение поля таблицы flatbuffer или None, если поле не записано
+    vtable = table - struct.unpack_from('<i', buf, table)[0]
+    vtable_size = struct.unpack_from('<H', buf, vtable)[0]
+    slot = 4 + 2 * field
+    if slot >= vtable_size:
+        return None
+    offset = struct.unpack_from('<H', buf, vtable + slot)[0]
+    return table + offset if offset else None
+
+
+def builtin_ops(buf):
+    # Коды встроенных операций из Model.operator_codes (поле 1) без повторов
+    model = struct.unpack_from('<I', buf, 0)[0]
+    codes = table_field(buf, model, 1)
+    if codes is None:
+        return []
+    vector = codes + struct.unpack_from('<I', buf, codes)[0]
+    ops = []
+    for i in range(struct.unpack_from('<I', buf, vector)[0]):
+        element = vector + 4 + 4 * i
+        op_code = element + struct.unpack_from('<I', buf, element)[0]
+        # deprecated_builtin_code (int8, поле 0) и builtin_code (int32, поле 3)
+        deprecated = table_field(buf, op_code, 0)
+        builtin = table_field(buf, op_code, 3)
+        code = max(struct.unpack_from('<b', buf, deprecated)[0] if deprecated else 0,
+                   struct.unpack_from('<i', buf, builtin)[0] if builtin else 0)
+        if code not in ops:
+            ops.append(code)
+    return ops
+
+
+def pack(model, version):
+    ops = builtin_ops(model)
+    if len(ops) > MODEL_MAX_OPS:
+        raise ValueError('операций больше MODEL_MAX_OPS: %d' % len(ops))
+    if MODEL_IMAGE_DATA_OFFSET + len(model) > PARTITION_SIZE:
+        raise ValueError('образ не помещается в раздел')
+    header = struct.pack('<IHHIII%di' % MODEL_MAX_OPS, MODEL_IMAGE_MAGIC, MODEL_IMAGE_FORMAT, len(ops),
+                         version, len(model), zlib.crc32(model), *(ops + [0] * (MODEL_MAX_OPS - len(ops))))
+    header += struct.pack('<I', zlib.crc32(header))
+    return header.ljust(MODEL_IMAGE_DATA_OFFSET, b'\xff') + model, ops
+
+
+def expect_reply(link, status):
+    # Строки протокола среди отладочного вывода прошивки
+    while True:
+        line = link.readline()
+        if not line:
+            raise RuntimeError('нет ответа от устройства')
+        words = line.decode('utf-8', 'replace').split()
+        if len(words) < 2 or words[0] != 'MODEL_WRITE':
+            continue
+        if words[1] != status:
+            raise RuntimeError('устройство: %s' % ' '.join(words[1:]))
+        return words[2:]
+
+
+def send(image, port):
+    # Протокол - src/model_hot_swap.h: команда, затем сектора с подтверждением
+    import serial
+    with serial.Serial(port, 115200, timeout=SEND_TIMEOUT_S) as link:
+        link.reset_input_buffer()
+        link.write(b'MODEL_WRITE %d\n' % len(image))
+        partition = expect_reply(link, 'OK')
+        for offset in range(0, len(image), FLASH_SECTOR_SIZE):
+            link.write(image[offset:offset + FLASH_SECTOR_SIZE])
+            last = offset + FLASH_SECTOR_SIZE >= len(image)
+            expect_reply(link, 'DONE' if last else 'OK')
+    return partition[0] if partition else '?'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Образ модели для раздела model')
+    parser.add_argument('tflite')
+    parser.add_argument('image')
+    parser.add_argument('--version', type=int, required=True)
+    parser.add_argument('--send', metavar='PORT',
+                        help='передать образ работающей прошивке (замена без перезагрузки)')
+    args = parser.parse_args()
+
+    with open(args.tflite, 'rb') as f:
+        model = f.read()
+    try:
+        image, ops = pack(model, args.version)
+    except ValueError as e:
+        sys.exit('Ошибка: %s' % e)
+    with open(args.image, 'wb') as f:
+        f.write(image)
+    print('Версия %d, модель %d байт, операции %s' % (args.version, len(model), ops))
+    if args.send:
+        try:
+            partition = send(image, args.send)
+        except (RuntimeError, OSError) as e:
+            sys.exit('Ошибка передачи: %s' % e)
+        print('Записан в раздел %s' % partition)
+
+
+if __name__ == '__main__':
+    main()